@@ -9,3 +9,6 @@
 enum zmk_activity_state { ZMK_ACTIVITY_ACTIVE, ZMK_ACTIVITY_IDLE, ZMK_ACTIVITY_SLEEP };
 
 enum zmk_activity_state zmk_activity_get_state(void);
+
+// Milliseconds since the last key position or sensor event.
+int32_t zmk_activity_get_inactive_time(void);
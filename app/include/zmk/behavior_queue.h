@@ -12,3 +12,6 @@
 
 int zmk_behavior_queue_add(uint32_t position, const struct zmk_behavior_binding behavior,
                            bool press, uint32_t wait);
+
+// Returns how many more items fit in the behavior queue right now.
+uint32_t zmk_behavior_queue_free_slots(void);
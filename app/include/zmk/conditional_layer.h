@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2021 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/devicetree.h>
+
+#include <zmk/keymap.h>
+
+#if DT_HAS_COMPAT_STATUS_OKAY(zmk_conditional_layers)
+
+/**
+ * Resolve all conditional layer configurations against a layer state and return the resulting
+ * state, with every then-layer set if and only if its if-layers are active. The default layer is
+ * never cleared. This does not raise any events.
+ */
+zmk_keymap_layers_state_t zmk_conditional_layer_apply(zmk_keymap_layers_state_t state,
+                                                      uint8_t default_layer);
+
+#else
+
+static inline zmk_keymap_layers_state_t
+zmk_conditional_layer_apply(zmk_keymap_layers_state_t state, uint8_t default_layer) {
+    return state;
+}
+
+#endif
@@ -70,6 +70,38 @@ struct zmk_endpoint_instance zmk_endpoints_selected(void);
 
 int zmk_endpoints_send_report(uint16_t usage_page);
 
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_STATS)
+struct zmk_endpoint_stats {
+    uint32_t sent;
+    uint32_t dropped;
+    // Time from handing a report to the transport until it was sent (USB) or notified (BLE).
+    uint32_t last_latency_us;
+    uint32_t max_latency_us;
+};
+
+/**
+ * Gets the HID report statistics of an endpoint instance since boot.
+ */
+int zmk_endpoints_get_stats(struct zmk_endpoint_instance endpoint,
+                            struct zmk_endpoint_stats *stats);
+
+/**
+ * Records the result of a report send. Used by the transports that queue reports.
+ */
+void zmk_endpoints_record_sent(struct zmk_endpoint_instance endpoint, uint32_t latency_us);
+void zmk_endpoints_record_dropped(struct zmk_endpoint_instance endpoint);
+#endif // IS_ENABLED(CONFIG_ZMK_ENDPOINTS_STATS)
+
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_SKIP_DUPLICATE_REPORTS)
+/**
+ * Forgets the last report of the usage page sent to an endpoint instance, so the next report is
+ * sent even if it is identical. Used by the transports that queue reports, when a queued report is
+ * dropped or fails to send.
+ */
+void zmk_endpoints_invalidate_sent_report(struct zmk_endpoint_instance endpoint,
+                                          uint16_t usage_page);
+#endif // IS_ENABLED(CONFIG_ZMK_ENDPOINTS_SKIP_DUPLICATE_REPORTS)
+
 #if IS_ENABLED(CONFIG_ZMK_MOUSE)
 int zmk_endpoints_send_mouse_report();
 #endif // IS_ENABLED(CONFIG_ZMK_MOUSE)
@@ -12,6 +12,7 @@
 
 struct zmk_event_type {
     const char *name;
+    size_t size;
 };
 
 typedef struct {
@@ -24,13 +25,41 @@ typedef struct {
 #define ZMK_EV_EVENT_CAPTURED 2
 
 typedef int (*zmk_listener_callback_t)(const zmk_event_t *eh);
+
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_ASYNC_LISTENERS)
+struct zmk_listener_async {
+    struct k_msgq *queue;
+    struct k_work work;
+    zmk_listener_callback_t callback;
+};
+#endif
+
 struct zmk_listener {
     zmk_listener_callback_t callback;
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_ASYNC_LISTENERS)
+    struct zmk_listener_async *async;
+#endif
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_TRACE)
+    const char *name;
+#endif
 };
 
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_TRACE)
+struct zmk_event_subscription_stats {
+    uint32_t invocations;
+    uint32_t handled;
+    uint32_t captured;
+    uint32_t max_cycles;
+    uint64_t total_cycles;
+};
+#endif
+
 struct zmk_event_subscription {
     const struct zmk_event_type *event_type;
     const struct zmk_listener *listener;
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_TRACE)
+    struct zmk_event_subscription_stats *stats;
+#endif
 };
 
 #define ZMK_EVENT_DECLARE(event_type)                                                              \
@@ -44,7 +73,8 @@ struct zmk_event_subscription {
     extern const struct zmk_event_type zmk_event_##event_type;
 
 #define ZMK_EVENT_IMPL(event_type)                                                                 \
-    const struct zmk_event_type zmk_event_##event_type = {.name = STRINGIFY(event_type)};          \
+    const struct zmk_event_type zmk_event_##event_type = {                                         \
+        .name = STRINGIFY(event_type), .size = sizeof(struct event_type##_event)};                 \
     const struct zmk_event_type *zmk_event_ref_##event_type __used                                 \
         __attribute__((__section__(".event_type"))) = &zmk_event_##event_type;                     \
     struct event_type##_event copy_raised_##event_type(const struct event_type *ev) {              \
@@ -61,7 +91,44 @@ struct zmk_event_subscription {
                                                       : NULL;                                      \
     };
 
-#define ZMK_LISTENER(mod, cb) const struct zmk_listener zmk_listener_##mod = {.callback = cb};
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_TRACE)
+#define ZMK_LISTENER_TRACE_INIT(mod) .name = STRINGIFY(mod),
+#define ZMK_SUBSCRIPTION_TRACE_INIT() .stats = &(struct zmk_event_subscription_stats){0},
+#else
+#define ZMK_LISTENER_TRACE_INIT(mod)
+#define ZMK_SUBSCRIPTION_TRACE_INIT()
+#endif
+
+#define ZMK_LISTENER(mod, cb)                                                                      \
+    const struct zmk_listener zmk_listener_##mod = {ZMK_LISTENER_TRACE_INIT(mod).callback = cb};
+
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_ASYNC_LISTENERS)
+
+#define ZMK_EVENT_ASYNC_ITEM_SIZE ROUND_UP(CONFIG_ZMK_EVENT_MANAGER_ASYNC_EVENT_SIZE, 8)
+
+/**
+ * Define a listener that is not invoked while the event is being raised. Instead, a copy of each
+ * subscribed event is put in a queue of `queue_size` entries, which is drained on the low priority
+ * work queue. The oldest queued event is dropped when the queue is full. The callback's return
+ * value is ignored, so async listeners can not handle or capture events.
+ *
+ * The callback runs after the event was raised, so it must only use the event itself and state
+ * it owns, never state that other threads keep changing, like the keymap or endpoints.
+ */
+#define ZMK_ASYNC_LISTENER(mod, cb, queue_size)                                                    \
+    K_MSGQ_DEFINE(zmk_listener_queue_##mod, ZMK_EVENT_ASYNC_ITEM_SIZE, queue_size, 8);            \
+    static struct zmk_listener_async zmk_listener_async_##mod = {                                  \
+        .queue = &zmk_listener_queue_##mod,                                                        \
+        .callback = cb,                                                                            \
+    };                                                                                             \
+    const struct zmk_listener zmk_listener_##mod = {                                               \
+        ZMK_LISTENER_TRACE_INIT(mod).callback = cb, .async = &zmk_listener_async_##mod};
+
+#else
+
+#define ZMK_ASYNC_LISTENER(mod, cb, queue_size) ZMK_LISTENER(mod, cb)
+
+#endif
 
 #define ZMK_SUBSCRIPTION(mod, ev_type)                                                             \
     const Z_DECL_ALIGN(struct zmk_event_subscription)                                              \
@@ -69,6 +136,7 @@ struct zmk_event_subscription {
         __attribute__((__section__(".event_subscription"))) = {                                    \
             .event_type = &zmk_event_##ev_type,                                                    \
             .listener = &zmk_listener_##mod,                                                       \
+            ZMK_SUBSCRIPTION_TRACE_INIT()                                                          \
     };
 
 #define ZMK_EVENT_RAISE(ev) zmk_event_manager_raise(&(ev).header)
@@ -83,4 +151,19 @@ struct zmk_event_subscription {
 int zmk_event_manager_raise(zmk_event_t *event);
 int zmk_event_manager_raise_after(zmk_event_t *event, const struct zmk_listener *listener);
 int zmk_event_manager_raise_at(zmk_event_t *event, const struct zmk_listener *listener);
-int zmk_event_manager_release(zmk_event_t *event);
\ No newline at end of file
+int zmk_event_manager_release(zmk_event_t *event);
+
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_TRACE)
+
+struct zmk_event_manager_trace_stats {
+    uint32_t dispatches;
+    uint32_t releases;
+    uint8_t depth;
+    uint8_t max_depth;
+};
+
+void zmk_event_manager_trace_get_stats(struct zmk_event_manager_trace_stats *stats);
+void zmk_event_manager_trace_reset(void);
+void zmk_event_manager_trace_dump(void);
+
+#endif
\ No newline at end of file
@@ -271,8 +271,17 @@ bool zmk_hid_mod_is_pressed(zmk_mod_t modifier);
 
 int zmk_hid_register_mods(zmk_mod_flags_t explicit_modifiers);
 int zmk_hid_unregister_mods(zmk_mod_flags_t explicit_modifiers);
-int zmk_hid_implicit_modifiers_press(zmk_mod_flags_t implicit_modifiers);
-int zmk_hid_implicit_modifiers_release(void);
+
+/**
+ * Apply the implicit modifiers of the key that pressed usage, replacing those of any earlier key.
+ * When that same usage is released, every press of it ends and the implicit modifiers of the most
+ * recently pressed key still held apply again. Releasing any other usage keeps them.
+ *
+ * @returns 1 if the report modifiers changed, 0 if they did not.
+ */
+int zmk_hid_implicit_modifiers_press(uint32_t usage, zmk_mod_flags_t implicit_modifiers);
+int zmk_hid_implicit_modifiers_release(uint32_t usage);
+
 int zmk_hid_masked_modifiers_set(zmk_mod_flags_t masked_modifiers);
 int zmk_hid_masked_modifiers_clear(void);
 
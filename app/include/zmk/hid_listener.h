@@ -0,0 +1,16 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+/**
+ * Open a batch of keycode events. Until the matching zmk_hid_listener_batch_end(), the HID state
+ * still changes with every event, but the keyboard and consumer reports are only sent once, when
+ * the outermost batch ends. If a usage changes twice in a batch, the reports held back so far are
+ * sent before the second change, so the host still sees both.
+ */
+void zmk_hid_listener_batch_begin(void);
+void zmk_hid_listener_batch_end(void);
@@ -6,14 +6,204 @@
 
 #pragma once
 
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <zephyr/devicetree.h>
+#include <zephyr/sys/util.h>
+
 #include <zmk/events/position_state_changed.h>
 
 #define ZMK_LAYER_CHILD_LEN_PLUS_ONE(node) 1 +
 #define ZMK_KEYMAP_LAYERS_LEN                                                                      \
     (DT_FOREACH_CHILD(DT_INST(0, zmk_keymap), ZMK_LAYER_CHILD_LEN_PLUS_ONE) 0)
 
+// Keymaps with up to 32 layers keep the layer state in a single word. Larger keymaps switch to an
+// array of words, accessed through the zmk_keymap_layers_state_* helpers below.
+#if DT_HAS_COMPAT_STATUS_OKAY(zmk_keymap)
+#if ZMK_KEYMAP_LAYERS_LEN > 32
+#define ZMK_KEYMAP_LAYERS_STATE_MULTI_WORD 1
+#endif
+#endif
+
+#if defined(ZMK_KEYMAP_LAYERS_STATE_MULTI_WORD)
+
+// Spelled out as a literal so that LISTIFY() can generate constant layer states. Layer indexes are
+// uint8_t, so there are never more than eight words.
+#if ZMK_KEYMAP_LAYERS_LEN > 224
+#define ZMK_KEYMAP_LAYERS_STATE_WORDS 8
+#elif ZMK_KEYMAP_LAYERS_LEN > 192
+#define ZMK_KEYMAP_LAYERS_STATE_WORDS 7
+#elif ZMK_KEYMAP_LAYERS_LEN > 160
+#define ZMK_KEYMAP_LAYERS_STATE_WORDS 6
+#elif ZMK_KEYMAP_LAYERS_LEN > 128
+#define ZMK_KEYMAP_LAYERS_STATE_WORDS 5
+#elif ZMK_KEYMAP_LAYERS_LEN > 96
+#define ZMK_KEYMAP_LAYERS_STATE_WORDS 4
+#elif ZMK_KEYMAP_LAYERS_LEN > 64
+#define ZMK_KEYMAP_LAYERS_STATE_WORDS 3
+#else
+#define ZMK_KEYMAP_LAYERS_STATE_WORDS 2
+#endif
+
+typedef struct {
+    uint32_t words[ZMK_KEYMAP_LAYERS_STATE_WORDS];
+} zmk_keymap_layers_state_t;
+
+#define ZMK_KEYMAP_LAYERS_STATE_INIT(word_fn, ...)                                                 \
+    {                                                                                              \
+        .words = {LISTIFY(ZMK_KEYMAP_LAYERS_STATE_WORDS, word_fn, (, ), __VA_ARGS__)}              \
+    }
+
+static inline zmk_keymap_layers_state_t zmk_keymap_layers_state_bit(uint8_t layer) {
+    zmk_keymap_layers_state_t state = {0};
+    state.words[layer / 32] = BIT(layer % 32);
+    return state;
+}
+
+static inline bool zmk_keymap_layers_state_test(zmk_keymap_layers_state_t state, uint8_t layer) {
+    return (state.words[layer / 32] & BIT(layer % 32)) != 0;
+}
+
+static inline zmk_keymap_layers_state_t
+zmk_keymap_layers_state_write(zmk_keymap_layers_state_t state, uint8_t layer, bool value) {
+    WRITE_BIT(state.words[layer / 32], layer % 32, value);
+    return state;
+}
+
+static inline zmk_keymap_layers_state_t zmk_keymap_layers_state_or(zmk_keymap_layers_state_t a,
+                                                                   zmk_keymap_layers_state_t b) {
+    for (int i = 0; i < ZMK_KEYMAP_LAYERS_STATE_WORDS; i++) {
+        a.words[i] |= b.words[i];
+    }
+    return a;
+}
+
+static inline zmk_keymap_layers_state_t zmk_keymap_layers_state_and(zmk_keymap_layers_state_t a,
+                                                                    zmk_keymap_layers_state_t b) {
+    for (int i = 0; i < ZMK_KEYMAP_LAYERS_STATE_WORDS; i++) {
+        a.words[i] &= b.words[i];
+    }
+    return a;
+}
+
+// Returns the layers in `a` that are not in `b`.
+static inline zmk_keymap_layers_state_t
+zmk_keymap_layers_state_and_not(zmk_keymap_layers_state_t a, zmk_keymap_layers_state_t b) {
+    for (int i = 0; i < ZMK_KEYMAP_LAYERS_STATE_WORDS; i++) {
+        a.words[i] &= ~b.words[i];
+    }
+    return a;
+}
+
+static inline bool zmk_keymap_layers_state_equal(zmk_keymap_layers_state_t a,
+                                                 zmk_keymap_layers_state_t b) {
+    for (int i = 0; i < ZMK_KEYMAP_LAYERS_STATE_WORDS; i++) {
+        if (a.words[i] != b.words[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static inline bool zmk_keymap_layers_state_empty(zmk_keymap_layers_state_t state) {
+    for (int i = 0; i < ZMK_KEYMAP_LAYERS_STATE_WORDS; i++) {
+        if (state.words[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Returns the highest layer set in the state, or -1 if no layer is set.
+static inline int zmk_keymap_layers_state_highest(zmk_keymap_layers_state_t state) {
+    for (int i = ZMK_KEYMAP_LAYERS_STATE_WORDS - 1; i >= 0; i--) {
+        if (state.words[i] != 0) {
+            return i * 32 + 31 - __builtin_clz(state.words[i]);
+        }
+    }
+    return -1;
+}
+
+#else
+
 typedef uint32_t zmk_keymap_layers_state_t;
 
+#define ZMK_KEYMAP_LAYERS_STATE_INIT(word_fn, ...) word_fn(0, __VA_ARGS__)
+
+static inline zmk_keymap_layers_state_t zmk_keymap_layers_state_bit(uint8_t layer) {
+    return BIT(layer);
+}
+
+static inline bool zmk_keymap_layers_state_test(zmk_keymap_layers_state_t state, uint8_t layer) {
+    return (state & BIT(layer)) != 0;
+}
+
+static inline zmk_keymap_layers_state_t
+zmk_keymap_layers_state_write(zmk_keymap_layers_state_t state, uint8_t layer, bool value) {
+    WRITE_BIT(state, layer, value);
+    return state;
+}
+
+static inline zmk_keymap_layers_state_t zmk_keymap_layers_state_or(zmk_keymap_layers_state_t a,
+                                                                   zmk_keymap_layers_state_t b) {
+    return a | b;
+}
+
+static inline zmk_keymap_layers_state_t zmk_keymap_layers_state_and(zmk_keymap_layers_state_t a,
+                                                                    zmk_keymap_layers_state_t b) {
+    return a & b;
+}
+
+// Returns the layers in `a` that are not in `b`.
+static inline zmk_keymap_layers_state_t
+zmk_keymap_layers_state_and_not(zmk_keymap_layers_state_t a, zmk_keymap_layers_state_t b) {
+    return a & ~b;
+}
+
+static inline bool zmk_keymap_layers_state_equal(zmk_keymap_layers_state_t a,
+                                                 zmk_keymap_layers_state_t b) {
+    return a == b;
+}
+
+static inline bool zmk_keymap_layers_state_empty(zmk_keymap_layers_state_t state) {
+    return state == 0;
+}
+
+// Returns the highest layer set in the state, or -1 if no layer is set.
+static inline int zmk_keymap_layers_state_highest(zmk_keymap_layers_state_t state) {
+    return state == 0 ? -1 : 31 - __builtin_clz(state);
+}
+
+#endif /* defined(ZMK_KEYMAP_LAYERS_STATE_MULTI_WORD) */
+
+/**
+ * Constant layer states are built with ZMK_KEYMAP_LAYERS_STATE_INIT(word_fn, ...), which expands to
+ * an initializer whose words are `word_fn(word, ...)`. The word functions below cover layers from
+ * devicetree properties and every layer of the keymap.
+ */
+
+// The bits of `layer` that fall into `word` of a layer state.
+#define ZMK_KEYMAP_LAYERS_STATE_LAYER_WORD(layer, word)                                            \
+    ((uint32_t)(((layer) / 32 == (word)) ? BIT((layer) % 32) : 0))
+
+#define ZMK_KEYMAP_LAYERS_STATE_PROP_ELEM_OR(node_id, prop, idx, word)                             \
+    | ZMK_KEYMAP_LAYERS_STATE_LAYER_WORD(DT_PROP_BY_IDX(node_id, prop, idx), word)
+
+// Word function for the layers listed in the array property `prop` of `node_id`.
+#define ZMK_KEYMAP_LAYERS_STATE_PROP_WORD(word, node_id, prop)                                     \
+    (0 DT_FOREACH_PROP_ELEM_VARGS(node_id, prop, ZMK_KEYMAP_LAYERS_STATE_PROP_ELEM_OR, word))
+
+// Word function for every layer of the keymap.
+#define ZMK_KEYMAP_LAYERS_STATE_ALL_WORD(word, ...)                                                \
+    ((uint32_t)BIT64_MASK(CLAMP(ZMK_KEYMAP_LAYERS_LEN - (word) * 32, 0, 32)))
+
+// Returns true if every layer in `mask` is also set in `state`.
+static inline bool zmk_keymap_layers_state_contains(zmk_keymap_layers_state_t state,
+                                                    zmk_keymap_layers_state_t mask) {
+    return zmk_keymap_layers_state_empty(zmk_keymap_layers_state_and_not(mask, state));
+}
+
 uint8_t zmk_keymap_layer_default(void);
 zmk_keymap_layers_state_t zmk_keymap_layer_state(void);
 bool zmk_keymap_layer_active(uint8_t layer);
@@ -22,6 +212,14 @@ int zmk_keymap_layer_activate(uint8_t layer);
 int zmk_keymap_layer_deactivate(uint8_t layer);
 int zmk_keymap_layer_toggle(uint8_t layer);
 int zmk_keymap_layer_to(uint8_t layer);
+
+/**
+ * Set every layer in `mask` to its bit in `value` as one transaction. Conditional layers are
+ * resolved on the result and a single layer state changed event carrying the old and new masks is
+ * raised, reporting `layer` as the layer the change was made for.
+ */
+int zmk_keymap_layers_update(zmk_keymap_layers_state_t mask, zmk_keymap_layers_state_t value,
+                             uint8_t layer);
 const char *zmk_keymap_layer_name(uint8_t layer);
 
 int zmk_keymap_position_state_changed(uint8_t source, uint32_t position, bool pressed,
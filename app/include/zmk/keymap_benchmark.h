@@ -0,0 +1,14 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+/**
+ * Time the keymap operations and print the results as JSON lines prefixed with
+ * "zmk_keymap_benchmark: ". Called from main() once the system has booted, before key scanning
+ * is enabled, so no key events are processed while it runs.
+ */
+void zmk_keymap_benchmark_run(void);
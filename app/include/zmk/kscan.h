@@ -9,3 +9,20 @@
 #include <zephyr/device.h>
 
 int zmk_kscan_init(const struct device *dev);
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_LATENCY_STATS)
+
+struct zmk_kscan_latency_stats {
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t total_us;
+    // The most events waiting in the kscan queue at once, and events dropped because it was full.
+    uint32_t max_queue_depth;
+    uint32_t dropped;
+};
+
+void zmk_kscan_get_latency_stats(struct zmk_kscan_latency_stats *stats);
+void zmk_kscan_reset_latency_stats(void);
+
+#endif
@@ -22,4 +22,26 @@ int zmk_split_bt_update_hid_indicator(zmk_hid_indicators_t indicators);
 
 int zmk_split_get_peripheral_battery_level(uint8_t source, uint8_t *level);
 
-#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING)
\ No newline at end of file
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING)
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_CONN_GOVERNOR)
+
+struct bt_le_conn_param;
+
+// Requests new connection parameters from every connected peripheral.
+void zmk_split_bt_central_update_conn_param(const struct bt_le_conn_param *param);
+
+// The connection parameters for the current governor mode, used for new connections.
+const struct bt_le_conn_param *zmk_split_bt_central_conn_governor_param(void);
+
+struct zmk_split_bt_central_conn_governor_stats {
+    // Milliseconds spent with the active and the idle connection parameters.
+    uint32_t active_ms;
+    uint32_t idle_ms;
+    // Number of switches between the two.
+    uint32_t updates;
+};
+
+void zmk_split_bt_central_conn_governor_get_stats(
+    struct zmk_split_bt_central_conn_governor_stats *stats);
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_CONN_GOVERNOR)
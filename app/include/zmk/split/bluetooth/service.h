@@ -30,8 +30,15 @@ struct zmk_split_run_behavior_payload {
     char behavior_dev[ZMK_SPLIT_RUN_BEHAVIOR_DEV_LEN];
 } __packed;
 
-int zmk_split_bt_position_pressed(uint8_t position);
-int zmk_split_bt_position_released(uint8_t position);
-int zmk_split_bt_sensor_triggered(uint8_t sensor_index,
-                                  const struct zmk_sensor_channel_data channel_data[],
-                                  size_t channel_data_size);
+/**
+ * Behavior IDs are indexes into the list of NUL separated behavior names the peripheral exposes
+ * through the behavior names characteristic. The list holds at most BT_ATT_MAX_ATTRIBUTE_LEN bytes
+ * of whole names, and behaviors past it have no ID. Writes to the run behavior by ID characteristic
+ * may contain several of these payloads back to back.
+ */
+#define ZMK_SPLIT_BEHAVIOR_ID_UNKNOWN UINT8_MAX
+
+struct zmk_split_run_behavior_id_payload {
+    uint8_t behavior_id;
+    struct zmk_split_run_behavior_data data;
+} __packed;
@@ -18,3 +18,5 @@
 #define ZMK_SPLIT_BT_CHAR_RUN_BEHAVIOR_UUID ZMK_BT_SPLIT_UUID(0x00000002)
 #define ZMK_SPLIT_BT_CHAR_SENSOR_STATE_UUID ZMK_BT_SPLIT_UUID(0x00000003)
 #define ZMK_SPLIT_BT_UPDATE_HID_INDICATORS_UUID ZMK_BT_SPLIT_UUID(0x00000004)
+#define ZMK_SPLIT_BT_CHAR_BEHAVIOR_NAMES_UUID ZMK_BT_SPLIT_UUID(0x00000005)
+#define ZMK_SPLIT_BT_CHAR_RUN_BEHAVIOR_BY_ID_UUID ZMK_BT_SPLIT_UUID(0x00000006)
@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+/**
+ * The in-memory transport connects the split transport API to a simulated other half in the same
+ * image, so the split protocol can be exercised and benchmarked on native_posix without a radio.
+ */
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+
+#define ZMK_SPLIT_MEMORY_PERIPHERAL_COUNT CONFIG_ZMK_SPLIT_MEMORY_PERIPHERALS
+
+/**
+ * Changes a key position on the simulated peripheral with the given source, which sends its new
+ * position state to the central. Key changes on the kscan selected by the zmk,split-memory-kscan
+ * chosen node are made with this, with the row as the source and the column as the position.
+ */
+int zmk_split_memory_peripheral_set_position(uint8_t source, uint32_t position, bool pressed);
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zmk/behavior.h>
+#include <zmk/split/transport/types.h>
+#include <zmk/events/position_state_changed.h>
+#include <zmk/events/sensor_event.h>
+#include <zmk/events/battery_state_changed.h>
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+#include <zmk/hid_indicators_types.h>
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+
+/**
+ * The operations the central uses to reach its peripherals. Exactly one split transport is built,
+ * and it registers its implementation with ZMK_SPLIT_TRANSPORT_CENTRAL_DEFINE.
+ */
+struct zmk_split_transport_central_api {
+    int (*invoke_behavior)(uint8_t source, struct zmk_behavior_binding *binding,
+                           struct zmk_behavior_binding_event event, bool state);
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+    int (*update_hid_indicator)(zmk_hid_indicators_t indicators);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+    bool (*is_peripheral_connected)(uint8_t source);
+};
+
+// An upper bound on the peripheral sources of the built transport, for sizing static state.
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE)
+#define ZMK_SPLIT_CENTRAL_MAX_PERIPHERALS CONFIG_ZMK_SPLIT_BLE_CENTRAL_PERIPHERALS
+#elif IS_ENABLED(CONFIG_ZMK_SPLIT_MEMORY)
+#define ZMK_SPLIT_CENTRAL_MAX_PERIPHERALS CONFIG_ZMK_SPLIT_MEMORY_PERIPHERALS
+#else
+#define ZMK_SPLIT_CENTRAL_MAX_PERIPHERALS 1
+#endif
+
+struct zmk_split_transport_central {
+    const struct zmk_split_transport_central_api *api;
+    uint8_t peripheral_count;
+};
+
+#define ZMK_SPLIT_TRANSPORT_CENTRAL_DEFINE(_api, _peripheral_count)                               \
+    const struct zmk_split_transport_central zmk_split_transport_central_impl = {                 \
+        .api = _api,                                                                               \
+        .peripheral_count = _peripheral_count,                                                     \
+    }
+
+uint8_t zmk_split_central_peripheral_count(void);
+
+bool zmk_split_central_is_peripheral_connected(uint8_t source);
+
+int zmk_split_central_invoke_behavior(uint8_t source, struct zmk_behavior_binding *binding,
+                                      struct zmk_behavior_binding_event event, bool state);
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+
+int zmk_split_central_update_hid_indicator(zmk_hid_indicators_t indicators);
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+
+/**
+ * Raises a position state changed event for each position that differs between the received
+ * state and last_state, then updates last_state. For transports that receive key positions as a
+ * bitmap and keep one last_state per peripheral. Must be called from the input work queue, unless
+ * CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN is enabled, in which case it may be called from any thread.
+ */
+void zmk_split_central_position_state_received(uint8_t source,
+                                               const uint8_t state[ZMK_SPLIT_POSITION_STATE_LEN],
+                                               uint8_t last_state[ZMK_SPLIT_POSITION_STATE_LEN]);
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN)
+
+/**
+ * Queue events received from a peripheral for the fan-in scheduler, which raises them from the
+ * input work queue. Safe to call from any thread.
+ */
+int zmk_split_central_fan_in_position_state_changed(struct zmk_position_state_changed ev);
+
+int zmk_split_central_fan_in_sensor_event(uint8_t source, struct zmk_sensor_event ev);
+
+/**
+ * Raises the position changes from zmk_split_central_position_state_received that did not fit in
+ * a fan-in queue. Called by the fan-in scheduler once it has made room.
+ */
+void zmk_split_central_position_state_retry(void);
+
+#if IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+
+int zmk_split_central_fan_in_peripheral_battery_state_changed(
+    struct zmk_peripheral_battery_state_changed ev);
+
+#endif // IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN_STATS)
+
+struct zmk_split_central_fan_in_stats {
+    // Events raised and events dropped because the peripheral's queue was full.
+    uint32_t raised;
+    uint32_t dropped;
+    // The most events queued for the peripheral at once.
+    uint32_t max_queue_depth;
+    // Time from queueing an event to raising it, in microseconds.
+    uint32_t last_latency_us;
+    uint32_t max_latency_us;
+};
+
+int zmk_split_central_fan_in_get_stats(uint8_t source,
+                                       struct zmk_split_central_fan_in_stats *stats);
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN_STATS)
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN)
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zmk/behavior.h>
+#include <zmk/sensors.h>
+#include <zmk/events/sensor_event.h>
+#include <zmk/split/transport/types.h>
+
+/**
+ * The operations a peripheral uses to reach the central. Exactly one split transport is built, and
+ * it registers its implementation with ZMK_SPLIT_TRANSPORT_PERIPHERAL_DEFINE.
+ */
+struct zmk_split_transport_peripheral_api {
+    int (*send_position_state)(const uint8_t state[ZMK_SPLIT_POSITION_STATE_LEN]);
+#if ZMK_KEYMAP_HAS_SENSORS
+    int (*send_sensor_event)(const struct zmk_sensor_event *ev);
+#endif /* ZMK_KEYMAP_HAS_SENSORS */
+#if IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+    // Optional, transports that report the battery level some other way leave this NULL.
+    int (*send_battery_level)(uint8_t level);
+#endif // IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+    bool (*is_connected)(void);
+};
+
+struct zmk_split_transport_peripheral {
+    const struct zmk_split_transport_peripheral_api *api;
+};
+
+#define ZMK_SPLIT_TRANSPORT_PERIPHERAL_DEFINE(_api)                                                \
+    const struct zmk_split_transport_peripheral zmk_split_transport_peripheral_impl = {           \
+        .api = _api,                                                                               \
+    }
+
+bool zmk_split_peripheral_is_connected(void);
+
+/**
+ * Runs a behavior the central asked this peripheral to invoke. Called by the transport from the
+ * context it receives the request in.
+ */
+int zmk_split_peripheral_run_behavior(struct zmk_behavior_binding *binding,
+                                      struct zmk_behavior_binding_event event, bool state);
@@ -0,0 +1,13 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+/**
+ * Peripherals report their key positions as a bitmap with one bit per position, so up to
+ * ZMK_SPLIT_POSITION_STATE_LEN * 8 positions can be reported.
+ */
+#define ZMK_SPLIT_POSITION_STATE_LEN 16
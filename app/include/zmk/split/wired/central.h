@@ -0,0 +1,17 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+#define ZMK_SPLIT_WIRED_PERIPHERAL_COUNT 1
+
+#if IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+
+int zmk_split_wired_get_peripheral_battery_level(uint8_t source, uint8_t *level);
+
+#endif // IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
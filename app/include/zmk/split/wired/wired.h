@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#pragma once
+
+#include <zephyr/kernel.h>
+
+#include <zmk/events/sensor_event.h>
+#include <zmk/sensors.h>
+
+/**
+ * Frames on the wire are: SOF, type, payload length, payload, then a little-endian CRC-16-CCITT
+ * of the type, length and payload bytes. Receivers drop frames with a bad CRC and resynchronize
+ * on the next SOF byte.
+ */
+#define ZMK_SPLIT_WIRED_FRAME_SOF 0x5A
+#define ZMK_SPLIT_WIRED_MAX_PAYLOAD_LEN 64
+
+#define ZMK_SPLIT_WIRED_BEHAVIOR_DEV_LEN 32
+
+enum zmk_split_wired_msg_type {
+    // Peripheral to central
+    ZMK_SPLIT_WIRED_MSG_POSITION_STATE = 1,
+    ZMK_SPLIT_WIRED_MSG_SENSOR_EVENT = 2,
+    ZMK_SPLIT_WIRED_MSG_BATTERY_LEVEL = 3,
+    // Central to peripheral
+    ZMK_SPLIT_WIRED_MSG_RUN_BEHAVIOR = 4,
+    ZMK_SPLIT_WIRED_MSG_HID_INDICATORS = 5,
+};
+
+struct zmk_split_wired_frame {
+    uint8_t type;
+    uint8_t len;
+    uint8_t payload[ZMK_SPLIT_WIRED_MAX_PAYLOAD_LEN];
+} __packed;
+
+struct zmk_split_wired_sensor_payload {
+    uint8_t sensor_index;
+    uint8_t channel_data_size;
+    struct zmk_sensor_channel_data channel_data[ZMK_SENSOR_EVENT_MAX_CHANNELS];
+} __packed;
+
+struct zmk_split_wired_run_behavior_payload {
+    uint8_t position;
+    uint8_t state;
+    uint32_t param1;
+    uint32_t param2;
+    // Only the bytes up to and including the NUL terminator are sent.
+    char behavior_dev[ZMK_SPLIT_WIRED_BEHAVIOR_DEV_LEN];
+} __packed;
+
+/**
+ * Queues a frame to be sent to the other half. If the queue is full, a queued position state frame
+ * superseded by a later one is dropped to make room.
+ *
+ * @returns -ENOMEM if the queue is full and no frame could be dropped.
+ */
+int zmk_split_wired_send(enum zmk_split_wired_msg_type type, const void *payload, uint8_t len);
+
+/**
+ * Handles a frame received from the other half. Implemented by the central or peripheral role and
+ * called from the input work queue.
+ */
+void zmk_split_wired_handle_frame(const struct zmk_split_wired_frame *frame);
@@ -1 +1,11 @@
+#pragma once
+
+#include <zephyr/kernel.h>
+
 struct k_work_q *zmk_workqueue_lowprio_work_q(void);
+
+#if IS_ENABLED(CONFIG_ZMK_INPUT_WORK_QUEUE)
+struct k_work_q *zmk_workqueue_input_work_q(void);
+#else
+static inline struct k_work_q *zmk_workqueue_input_work_q(void) { return &k_sys_work_q; }
+#endif
@@ -114,9 +114,63 @@ static int state_index_io(const struct kscan_matrix_config *config, const int in
                : state_index_rc(config, input_idx, output_idx);
 }
 
+#define USE_BATCH_OUTPUTS IS_ENABLED(CONFIG_ZMK_KSCAN_MATRIX_BATCH_OUTPUTS)
+
+/**
+ * Returns true if the output at index i is the first output on its port.
+ */
+static bool kscan_matrix_is_first_output_on_port(const struct kscan_matrix_config *config,
+                                                 const int i) {
+    for (int j = 0; j < i; j++) {
+        if (config->outputs.gpios[j].spec.port == config->outputs.gpios[i].spec.port) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Get the mask of all outputs on the same port as the output at index i.
+ */
+static gpio_port_pins_t kscan_matrix_port_outputs_mask(const struct kscan_matrix_config *config,
+                                                       const int i) {
+    gpio_port_pins_t mask = 0;
+
+    for (int j = i; j < config->outputs.len; j++) {
+        const struct gpio_dt_spec *gpio = &config->outputs.gpios[j].spec;
+
+        if (gpio->port == config->outputs.gpios[i].spec.port) {
+            mask |= BIT(gpio->pin);
+        }
+    }
+
+    return mask;
+}
+
 static int kscan_matrix_set_all_outputs(const struct device *dev, const int value) {
     const struct kscan_matrix_config *config = dev->config;
 
+    if (USE_BATCH_OUTPUTS) {
+        for (int i = 0; i < config->outputs.len; i++) {
+            if (!kscan_matrix_is_first_output_on_port(config, i)) {
+                continue;
+            }
+
+            const struct device *port = config->outputs.gpios[i].spec.port;
+            const gpio_port_pins_t mask = kscan_matrix_port_outputs_mask(config, i);
+
+            // gpio_port_set_masked() applies the active level of each pin like gpio_pin_set().
+            int err = gpio_port_set_masked(port, mask, value ? mask : 0);
+            if (err) {
+                LOG_ERR("Failed to set outputs on %s to %i: %i", port->name, value, err);
+                return err;
+            }
+        }
+
+        return 0;
+    }
+
     for (int i = 0; i < config->outputs.len; i++) {
         const struct gpio_dt_spec *gpio = &config->outputs.gpios[i].spec;
 
@@ -218,14 +272,20 @@ static int kscan_matrix_read(const struct device *dev) {
     struct kscan_matrix_data *data = dev->data;
     const struct kscan_matrix_config *config = dev->config;
 
+    // Set when the previous output was deactivated in the same write that activated this one.
+    bool output_already_active = false;
+
     // Scan the matrix.
     for (int i = 0; i < config->outputs.len; i++) {
         const struct kscan_gpio *out_gpio = &config->outputs.gpios[i];
+        int err;
 
-        int err = gpio_pin_set_dt(&out_gpio->spec, 1);
-        if (err) {
-            LOG_ERR("Failed to set output %i active: %i", out_gpio->index, err);
-            return err;
+        if (!output_already_active) {
+            err = gpio_pin_set_dt(&out_gpio->spec, 1);
+            if (err) {
+                LOG_ERR("Failed to set output %i active: %i", out_gpio->index, err);
+                return err;
+            }
         }
 
 #if CONFIG_ZMK_KSCAN_MATRIX_WAIT_BEFORE_INPUTS > 0
@@ -247,6 +307,27 @@ static int kscan_matrix_read(const struct device *dev) {
                                 &config->debounce_config);
         }
 
+        const struct kscan_gpio *next_gpio =
+            (i + 1 < config->outputs.len) ? &config->outputs.gpios[i + 1] : NULL;
+
+        output_already_active = USE_BATCH_OUTPUTS &&
+                                CONFIG_ZMK_KSCAN_MATRIX_WAIT_BETWEEN_OUTPUTS == 0 &&
+                                next_gpio && next_gpio->spec.port == out_gpio->spec.port;
+
+        if (output_already_active) {
+            const gpio_port_pins_t current = BIT(out_gpio->spec.pin);
+            const gpio_port_pins_t next = BIT(next_gpio->spec.pin);
+
+            err = gpio_port_set_masked(out_gpio->spec.port, current | next, next);
+            if (err) {
+                LOG_ERR("Failed to switch output %i to %i: %i", out_gpio->index, next_gpio->index,
+                        err);
+                return err;
+            }
+
+            continue;
+        }
+
         err = gpio_pin_set_dt(&out_gpio->spec, 0);
         if (err) {
             LOG_ERR("Failed to set output %i inactive: %i", out_gpio->index, err);
@@ -16,14 +16,131 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #include <dt-bindings/zmk/kscan_mock.h>
 
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_MOCK_TRACE)
+#include <stdio.h>
+#include <string.h>
+
+#include "soc.h"
+#include "cmdline.h"
+#endif
+
+struct kscan_mock_trace_event {
+    int64_t timestamp;
+    uint32_t row;
+    uint32_t column;
+    bool pressed;
+};
+
 struct kscan_mock_data {
     kscan_callback_t callback;
 
     uint32_t event_index;
     struct k_work_delayable work;
     const struct device *dev;
+
+    bool streaming;
+    bool trace_ended;
+    struct kscan_mock_trace_event trace_event;
 };
 
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_MOCK_TRACE)
+
+static char *trace_path;
+static FILE *trace_file;
+
+static void kscan_mock_trace_options(void) {
+    static struct args_struct_t options[] = {
+        {.option = "kscan-trace",
+         .name = "path",
+         .type = 's',
+         .dest = (void *)&trace_path,
+         .descript = "Replay mock kscan events from a trace file instead of devicetree, "
+                     "or from stdin if path is -"},
+        ARG_TABLE_ENDMARKER};
+
+    native_add_command_line_opts(options);
+}
+
+NATIVE_TASK(kscan_mock_trace_options, PRE_BOOT_1, 10);
+
+static int kscan_mock_trace_open(struct kscan_mock_data *data) {
+    if (trace_path == NULL) {
+        return 0;
+    }
+
+    trace_file = strcmp(trace_path, "-") == 0 ? stdin : fopen(trace_path, "r");
+    if (trace_file == NULL) {
+        LOG_ERR("Failed to open kscan trace %s", trace_path);
+        return -ENOENT;
+    }
+
+    data->streaming = true;
+    return 0;
+}
+
+// Each line is "<uptime ms> <p|r> <row> <column>". Blank lines and lines starting with # are
+// skipped. Lines are read as they are needed, so traces of any length replay in constant memory.
+static bool kscan_mock_trace_read(struct kscan_mock_trace_event *ev) {
+    char line[64];
+
+    while (fgets(line, sizeof(line), trace_file) != NULL) {
+        long long timestamp;
+        char state;
+
+        if (line[0] == '#' || line[0] == '\n') {
+            continue;
+        }
+
+        if (sscanf(line, "%lld %c %u %u", &timestamp, &state, &ev->row, &ev->column) != 4 ||
+            (state != 'p' && state != 'r')) {
+            LOG_WRN("Skipping malformed kscan trace line: %s", line);
+            continue;
+        }
+
+        ev->timestamp = timestamp;
+        ev->pressed = (state == 'p');
+        return true;
+    }
+
+    return false;
+}
+
+static void kscan_mock_trace_schedule_next(struct kscan_mock_data *data) {
+    if (!kscan_mock_trace_read(&data->trace_event)) {
+        // Run once more, so the last event is processed before exiting.
+        data->trace_ended = true;
+        k_work_schedule(&data->work, K_NO_WAIT);
+        return;
+    }
+
+    int64_t delay = data->trace_event.timestamp - k_uptime_get();
+    k_work_schedule(&data->work, K_MSEC(MAX(delay, 0)));
+}
+
+static void kscan_mock_trace_report(struct kscan_mock_data *data, bool exit_after) {
+    if (data->trace_ended) {
+        if (exit_after) {
+            LOG_DBG("Exiting");
+            exit(0);
+        }
+        return;
+    }
+
+    struct kscan_mock_trace_event *ev = &data->trace_event;
+    LOG_DBG("trace ev at %lld row %d column %d state %d\n", ev->timestamp, ev->row, ev->column,
+            ev->pressed);
+    data->callback(data->dev, ev->row, ev->column, ev->pressed);
+    kscan_mock_trace_schedule_next(data);
+}
+
+#else
+
+static inline int kscan_mock_trace_open(struct kscan_mock_data *data) { return 0; }
+static inline void kscan_mock_trace_schedule_next(struct kscan_mock_data *data) {}
+static inline void kscan_mock_trace_report(struct kscan_mock_data *data, bool exit_after) {}
+
+#endif // IS_ENABLED(CONFIG_ZMK_KSCAN_MOCK_TRACE)
+
 static int kscan_mock_disable_callback(const struct device *dev) {
     struct kscan_mock_data *data = dev->data;
 
@@ -46,13 +163,15 @@ static int kscan_mock_configure(const struct device *dev, kscan_callback_t callb
 
 #define MOCK_INST_INIT(n)                                                                          \
     struct kscan_mock_config_##n {                                                                 \
-        uint32_t events[DT_INST_PROP_LEN(n, events)];                                              \
+        uint32_t events[DT_INST_PROP_LEN_OR(n, events, 0)];                                        \
         bool exit_after;                                                                           \
     };                                                                                             \
     static void kscan_mock_schedule_next_event_##n(const struct device *dev) {                     \
         struct kscan_mock_data *data = dev->data;                                                  \
         const struct kscan_mock_config_##n *cfg = dev->config;                                     \
-        if (data->event_index < DT_INST_PROP_LEN(n, events)) {                                     \
+        if (data->streaming) {                                                                     \
+            kscan_mock_trace_schedule_next(data);                                                  \
+        } else if (data->event_index < DT_INST_PROP_LEN_OR(n, events, 0)) {                        \
             uint32_t ev = cfg->events[data->event_index];                                          \
             LOG_DBG("delaying next keypress: %d", ZMK_MOCK_MSEC(ev));                              \
             k_work_schedule(&data->work, K_MSEC(ZMK_MOCK_MSEC(ev)));                               \
@@ -65,6 +184,10 @@ static int kscan_mock_configure(const struct device *dev, kscan_callback_t callb
         struct k_work_delayable *d_work = k_work_delayable_from_work(work);                        \
         struct kscan_mock_data *data = CONTAINER_OF(d_work, struct kscan_mock_data, work);         \
         const struct kscan_mock_config_##n *cfg = data->dev->config;                               \
+        if (data->streaming) {                                                                     \
+            kscan_mock_trace_report(data, cfg->exit_after);                                        \
+            return;                                                                                \
+        }                                                                                          \
         uint32_t ev = cfg->events[data->event_index];                                              \
         LOG_DBG("ev %u row %d column %d state %d\n", ev, ZMK_MOCK_ROW(ev), ZMK_MOCK_COL(ev),       \
                 ZMK_MOCK_IS_PRESS(ev));                                                            \
@@ -76,7 +199,7 @@ static int kscan_mock_configure(const struct device *dev, kscan_callback_t callb
         struct kscan_mock_data *data = dev->data;                                                  \
         data->dev = dev;                                                                           \
         k_work_init_delayable(&data->work, kscan_mock_work_handler_##n);                           \
-        return 0;                                                                                  \
+        return n == 0 ? kscan_mock_trace_open(data) : 0;                                           \
     }                                                                                              \
     static int kscan_mock_enable_callback_##n(const struct device *dev) {                          \
         kscan_mock_schedule_next_event_##n(dev);                                                   \
@@ -89,7 +212,7 @@ static int kscan_mock_configure(const struct device *dev, kscan_callback_t callb
     };                                                                                             \
     static struct kscan_mock_data kscan_mock_data_##n;                                             \
     static const struct kscan_mock_config_##n kscan_mock_config_##n = {                            \
-        .events = DT_INST_PROP(n, events), .exit_after = DT_INST_PROP(n, exit_after)};             \
+        .events = DT_INST_PROP_OR(n, events, {}), .exit_after = DT_INST_PROP(n, exit_after)};      \
     DEVICE_DT_INST_DEFINE(n, kscan_mock_init_##n, NULL, &kscan_mock_data_##n,                      \
                           &kscan_mock_config_##n, POST_KERNEL, CONFIG_KSCAN_INIT_PRIORITY,         \
                           &mock_driver_api_##n);
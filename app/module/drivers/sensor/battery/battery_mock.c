@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define DT_DRV_COMPAT zmk_battery_mock
+
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/logging/log.h>
+
+#include "battery_common.h"
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+struct battery_mock_config {
+    const uint8_t *samples;
+    size_t samples_len;
+};
+
+struct battery_mock_data {
+    size_t sample_index;
+    struct battery_value value;
+};
+
+// Each fetch reads the next state of charge from devicetree, then keeps repeating the last one.
+static int battery_mock_sample_fetch(const struct device *dev, enum sensor_channel chan) {
+    struct battery_mock_data *data = dev->data;
+    const struct battery_mock_config *config = dev->config;
+
+    if (chan != SENSOR_CHAN_GAUGE_STATE_OF_CHARGE && chan != SENSOR_CHAN_ALL) {
+        return -ENOTSUP;
+    }
+
+    data->value.state_of_charge = config->samples[data->sample_index];
+    if (data->sample_index + 1 < config->samples_len) {
+        data->sample_index++;
+    }
+
+    return 0;
+}
+
+static int battery_mock_channel_get(const struct device *dev, enum sensor_channel chan,
+                                    struct sensor_value *val) {
+    struct battery_mock_data *data = dev->data;
+
+    return battery_channel_get(&data->value, chan, val);
+}
+
+static const struct sensor_driver_api battery_mock_api = {
+    .sample_fetch = battery_mock_sample_fetch,
+    .channel_get = battery_mock_channel_get,
+};
+
+static const uint8_t battery_mock_samples[] = DT_INST_PROP(0, samples);
+
+static struct battery_mock_data battery_mock_data;
+
+static const struct battery_mock_config battery_mock_config = {
+    .samples = battery_mock_samples,
+    .samples_len = ARRAY_SIZE(battery_mock_samples),
+};
+
+DEVICE_DT_INST_DEFINE(0, NULL, NULL, &battery_mock_data, &battery_mock_config, POST_KERNEL,
+                      CONFIG_SENSOR_INIT_PRIORITY, &battery_mock_api);
@@ -20,46 +20,46 @@
 
 LOG_MODULE_REGISTER(EC11, CONFIG_SENSOR_LOG_LEVEL);
 
-static int ec11_get_ab_state(const struct device *dev) {
+/*
+ * Quadrature steps indexed by (previous AB state << 2 | new AB state). Transitions where both
+ * pins changed at once are invalid (bounce or a missed edge) and decode to no movement.
+ */
+static const int8_t ec11_step_table[16] = {
+    0, 1, -1, 0, -1, 0, 0, 1, 1, 0, 0, -1, 0, -1, 1, 0,
+};
+
+int ec11_get_ab_state(const struct device *dev) {
     const struct ec11_config *drv_cfg = dev->config;
 
     return (gpio_pin_get_dt(&drv_cfg->a) << 1) | gpio_pin_get_dt(&drv_cfg->b);
 }
 
+int8_t ec11_decode_step(uint8_t prev_ab_state, uint8_t ab_state) {
+    return ec11_step_table[((prev_ab_state & 0b11) << 2) | (ab_state & 0b11)];
+}
+
 static int ec11_sample_fetch(const struct device *dev, enum sensor_channel chan) {
     struct ec11_data *drv_data = dev->data;
     const struct ec11_config *drv_cfg = dev->config;
-    uint8_t val;
     int8_t delta;
 
     __ASSERT_NO_MSG(chan == SENSOR_CHAN_ALL || chan == SENSOR_CHAN_ROTATION);
 
-    val = ec11_get_ab_state(dev);
+#if defined(CONFIG_EC11_TRIGGER_ISR)
+    // Edges are decoded in the interrupt, just collect what accumulated since the last fetch.
+    delta = CLAMP(atomic_clear(&drv_data->isr_pulses), INT8_MIN, INT8_MAX);
+#else
+    uint8_t val = ec11_get_ab_state(dev);
 
     LOG_DBG("prev: %d, new: %d", drv_data->ab_state, val);
 
-    switch (val | (drv_data->ab_state << 2)) {
-    case 0b0010:
-    case 0b0100:
-    case 0b1101:
-    case 0b1011:
-        delta = -1;
-        break;
-    case 0b0001:
-    case 0b0111:
-    case 0b1110:
-    case 0b1000:
-        delta = 1;
-        break;
-    default:
-        delta = 0;
-        break;
-    }
+    delta = ec11_decode_step(drv_data->ab_state, val);
+    drv_data->ab_state = val;
+#endif
 
     LOG_DBG("Delta: %d", delta);
 
     drv_data->pulses += delta;
-    drv_data->ab_state = val;
 
     // TODO: Temporary code for backwards compatibility to support
     // the sensor channel rotation reporting *ticks* instead of delta of degrees.
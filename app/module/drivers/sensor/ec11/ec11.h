@@ -8,6 +8,7 @@
 
 #include <zephyr/device.h>
 #include <zephyr/drivers/gpio.h>
+#include <zephyr/sys/atomic.h>
 #include <zephyr/sys/util.h>
 
 struct ec11_config {
@@ -24,6 +25,11 @@ struct ec11_data {
     int8_t ticks;
     int8_t delta;
 
+#if defined(CONFIG_EC11_TRIGGER_ISR)
+    /* Steps decoded in the interrupt that have not been fetched yet */
+    atomic_t isr_pulses;
+#endif
+
 #ifdef CONFIG_EC11_TRIGGER
     struct gpio_callback a_gpio_cb;
     struct gpio_callback b_gpio_cb;
@@ -43,6 +49,9 @@ struct ec11_data {
 #endif /* CONFIG_EC11_TRIGGER */
 };
 
+int ec11_get_ab_state(const struct device *dev);
+int8_t ec11_decode_step(uint8_t prev_ab_state, uint8_t ab_state);
+
 #ifdef CONFIG_EC11_TRIGGER
 
 int ec11_trigger_set(const struct device *dev, const struct sensor_trigger *trig,
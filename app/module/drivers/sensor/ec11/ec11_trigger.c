@@ -33,10 +33,32 @@ static inline void setup_int(const struct device *dev, bool enable) {
     }
 }
 
+#if defined(CONFIG_EC11_TRIGGER_ISR)
+static void ec11_isr_decode(struct ec11_data *drv_data) {
+    uint8_t val = ec11_get_ab_state(drv_data->dev);
+    int8_t delta = ec11_decode_step(drv_data->ab_state, val);
+
+    drv_data->ab_state = val;
+
+    if (delta == 0) {
+        return;
+    }
+
+    atomic_add(&drv_data->isr_pulses, delta);
+
+    if (drv_data->handler) {
+        drv_data->handler(drv_data->dev, drv_data->trigger);
+    }
+}
+#endif
+
 static void ec11_a_gpio_callback(const struct device *dev, struct gpio_callback *cb,
                                  uint32_t pins) {
     struct ec11_data *drv_data = CONTAINER_OF(cb, struct ec11_data, a_gpio_cb);
 
+#if defined(CONFIG_EC11_TRIGGER_ISR)
+    ec11_isr_decode(drv_data);
+#else
     LOG_DBG("");
 
     setup_int(drv_data->dev, false);
@@ -46,12 +68,16 @@ static void ec11_a_gpio_callback(const struct device *dev, struct gpio_callback
 #elif defined(CONFIG_EC11_TRIGGER_GLOBAL_THREAD)
     k_work_submit(&drv_data->work);
 #endif
+#endif
 }
 
 static void ec11_b_gpio_callback(const struct device *dev, struct gpio_callback *cb,
                                  uint32_t pins) {
     struct ec11_data *drv_data = CONTAINER_OF(cb, struct ec11_data, b_gpio_cb);
 
+#if defined(CONFIG_EC11_TRIGGER_ISR)
+    ec11_isr_decode(drv_data);
+#else
     LOG_DBG("");
 
     setup_int(drv_data->dev, false);
@@ -61,8 +87,10 @@ static void ec11_b_gpio_callback(const struct device *dev, struct gpio_callback
 #elif defined(CONFIG_EC11_TRIGGER_GLOBAL_THREAD)
     k_work_submit(&drv_data->work);
 #endif
+#endif
 }
 
+#if defined(CONFIG_EC11_TRIGGER_OWN_THREAD) || defined(CONFIG_EC11_TRIGGER_GLOBAL_THREAD)
 static void ec11_thread_cb(const struct device *dev) {
     struct ec11_data *drv_data = dev->data;
 
@@ -70,6 +98,7 @@ static void ec11_thread_cb(const struct device *dev) {
 
     setup_int(dev, true);
 }
+#endif
 
 #ifdef CONFIG_EC11_TRIGGER_OWN_THREAD
 static void ec11_thread(int dev_ptr, int unused) {
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#define DT_DRV_COMPAT zmk_sensor_mock
+
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+struct sensor_mock_config {
+    // Pairs of a rotation in degrees and the milliseconds to wait before the next one.
+    const uint32_t *events;
+    size_t events_len;
+};
+
+struct sensor_mock_data {
+    const struct device *dev;
+    sensor_trigger_handler_t handler;
+    const struct sensor_trigger *trigger;
+    struct k_work_delayable work;
+    size_t event_index;
+    int32_t rotation;
+};
+
+static void sensor_mock_work_callback(struct k_work *work) {
+    struct k_work_delayable *d_work = k_work_delayable_from_work(work);
+    struct sensor_mock_data *data = CONTAINER_OF(d_work, struct sensor_mock_data, work);
+    const struct sensor_mock_config *config = data->dev->config;
+
+    if (data->event_index + 1 >= config->events_len) {
+        return;
+    }
+
+    data->rotation = (int32_t)config->events[data->event_index];
+    uint32_t delay = config->events[data->event_index + 1];
+    data->event_index += 2;
+
+    LOG_DBG("Mock sensor rotated %d degrees", data->rotation);
+    data->handler(data->dev, data->trigger);
+
+    k_work_schedule(&data->work, K_MSEC(delay));
+}
+
+static int sensor_mock_trigger_set(const struct device *dev, const struct sensor_trigger *trig,
+                                   sensor_trigger_handler_t handler) {
+    struct sensor_mock_data *data = dev->data;
+
+    data->handler = handler;
+    data->trigger = trig;
+
+    if (handler != NULL) {
+        k_work_schedule(&data->work, K_NO_WAIT);
+    } else {
+        k_work_cancel_delayable(&data->work);
+    }
+
+    return 0;
+}
+
+static int sensor_mock_sample_fetch(const struct device *dev, enum sensor_channel chan) {
+    return 0;
+}
+
+static int sensor_mock_channel_get(const struct device *dev, enum sensor_channel chan,
+                                   struct sensor_value *val) {
+    struct sensor_mock_data *data = dev->data;
+
+    if (chan != SENSOR_CHAN_ROTATION) {
+        return -ENOTSUP;
+    }
+
+    val->val1 = data->rotation;
+    val->val2 = 0;
+    return 0;
+}
+
+static const struct sensor_driver_api sensor_mock_api = {
+    .trigger_set = sensor_mock_trigger_set,
+    .sample_fetch = sensor_mock_sample_fetch,
+    .channel_get = sensor_mock_channel_get,
+};
+
+static int sensor_mock_init(const struct device *dev) {
+    struct sensor_mock_data *data = dev->data;
+
+    data->dev = dev;
+    k_work_init_delayable(&data->work, sensor_mock_work_callback);
+    return 0;
+}
+
+#define SENSOR_MOCK_INST(n)                                                                        \
+    static const uint32_t sensor_mock_events_##n[] = DT_INST_PROP(n, events);                      \
+    static struct sensor_mock_data sensor_mock_data_##n;                                           \
+    static const struct sensor_mock_config sensor_mock_config_##n = {                              \
+        .events = sensor_mock_events_##n,                                                          \
+        .events_len = ARRAY_SIZE(sensor_mock_events_##n),                                          \
+    };                                                                                             \
+    DEVICE_DT_INST_DEFINE(n, sensor_mock_init, NULL, &sensor_mock_data_##n,                        \
+                          &sensor_mock_config_##n, POST_KERNEL, CONFIG_SENSOR_INIT_PRIORITY,       \
+                          &sensor_mock_api);
+
+DT_INST_FOREACH_STATUS_OKAY(SENSOR_MOCK_INST)
@@ -32,7 +32,25 @@ if [ $? -gt 0 ]; then
     exit 1
 fi
 
-./build/$testcase/zephyr/zmk.exe | sed -e "s/.*> //" | tee build/$testcase/keycode_events_full.log | sed -n -f $testcase/events.patterns > build/$testcase/keycode_events.log
+# Skip ahead to the next timeout whenever every thread is idle, instead of waiting for it in real
+# time. The simulated timeline, and so the output, is the same either way.
+time_args=""
+if [ -z "${ZMK_TESTS_REAL_TIME}" ]; then
+    time_args="--no-rt"
+fi
+
+# Test cases can replay a kscan trace instead of devicetree events, see CONFIG_ZMK_KSCAN_MOCK_TRACE.
+# Test cases with a record-replay file record their devicetree events to a trace first, see
+# CONFIG_ZMK_KSCAN_TRACE_RECORD, and check the output of replaying that.
+run_args="$time_args"
+if [ -f $testcase/record-replay ]; then
+    ./build/$testcase/zephyr/zmk.exe --kscan-record=build/$testcase/kscan.trace $time_args > /dev/null
+    run_args="$run_args --kscan-trace=build/$testcase/kscan.trace"
+elif [ -f $testcase/kscan.trace ]; then
+    run_args="$run_args --kscan-trace=$testcase/kscan.trace"
+fi
+
+./build/$testcase/zephyr/zmk.exe $run_args | sed -e "s/.*> //" | tee build/$testcase/keycode_events_full.log | sed -n -f $testcase/events.patterns > build/$testcase/keycode_events.log
 diff -auZ $testcase/keycode_events.snapshot build/$testcase/keycode_events.log
 if [ $? -gt 0 ]; then
     if [ -f $testcase/pending ]; then
@@ -24,6 +24,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #if IS_ENABLED(CONFIG_USB_DEVICE_STACK)
 #include <zmk/usb.h>
+#include <zmk/workqueue.h>
 #endif
 
 // Reimplement some of the device work from Zephyr PM to work with the new `sys_poweroff` API.
@@ -116,6 +117,11 @@ int set_state(enum zmk_activity_state state) {
 
 enum zmk_activity_state zmk_activity_get_state(void) { return activity_state; }
 
+int32_t zmk_activity_get_inactive_time(void) {
+    int32_t current = k_uptime_get();
+    return current - activity_last_uptime;
+}
+
 int activity_event_listener(const zmk_event_t *eh) {
     activity_last_uptime = k_uptime_get();
 
@@ -123,8 +129,7 @@ int activity_event_listener(const zmk_event_t *eh) {
 }
 
 void activity_work_handler(struct k_work *work) {
-    int32_t current = k_uptime_get();
-    int32_t inactive_time = current - activity_last_uptime;
+    int32_t inactive_time = zmk_activity_get_inactive_time();
 #if IS_ENABLED(CONFIG_ZMK_SLEEP)
     if (inactive_time > MAX_SLEEP_MS && !is_usb_power_present()) {
         // Put devices in suspend power mode before sleeping
@@ -146,7 +151,9 @@ void activity_work_handler(struct k_work *work) {
 
 K_WORK_DEFINE(activity_work, activity_work_handler);
 
-void activity_expiry_function(struct k_timer *_timer) { k_work_submit(&activity_work); }
+void activity_expiry_function(struct k_timer *_timer) {
+    k_work_submit_to_queue(zmk_workqueue_input_work_q(), &activity_work);
+}
 
 K_TIMER_DEFINE(activity_timer, activity_expiry_function, NULL);
 
@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <stdlib.h>
+
 #include <zephyr/device.h>
 #include <zephyr/devicetree.h>
 #include <zephyr/init.h>
@@ -22,6 +24,11 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/activity.h>
 #include <zmk/workqueue.h>
 
+#if IS_ENABLED(CONFIG_ZMK_BATTERY_ADAPTIVE_SAMPLING) && IS_ENABLED(CONFIG_USB_DEVICE_STACK)
+#include <zmk/usb.h>
+#include <zmk/events/usb_conn_state_changed.h>
+#endif
+
 static uint8_t last_state_of_charge = 0;
 
 uint8_t zmk_battery_state_of_charge(void) { return last_state_of_charge; }
@@ -34,6 +41,98 @@ static const struct device *const battery = DEVICE_DT_GET(DT_CHOSEN(zmk_battery)
 static const struct device *battery;
 #endif
 
+#if IS_ENABLED(CONFIG_ZMK_BATTERY_ADAPTIVE_SAMPLING)
+
+#define BATTERY_FILTER_WINDOW 3
+
+// Median-of-three to drop single outliers (e.g. a sample taken during a radio TX burst), followed
+// by a fixed point IIR low pass to smooth out the slow ADC noise.
+struct battery_filter {
+    uint8_t window[BATTERY_FILTER_WINDOW];
+    uint8_t count;
+    uint8_t head;
+    int32_t iir_q8;
+};
+
+static struct battery_filter filter;
+static bool state_of_charge_reported = false;
+
+static uint32_t sample_interval = CONFIG_ZMK_BATTERY_REPORT_INTERVAL;
+static uint8_t fast_samples_remaining = 0;
+
+static void battery_filter_reset(void) { filter = (struct battery_filter){0}; }
+
+static uint8_t battery_filter_median(void) {
+    uint8_t a = filter.window[0], b = filter.window[1], c = filter.window[2];
+
+    if (a > b) {
+        uint8_t t = a;
+        a = b;
+        b = t;
+    }
+
+    return c < a ? a : (c > b ? b : c);
+}
+
+static uint8_t battery_filter_apply(uint8_t raw) {
+    filter.window[filter.head] = raw;
+    filter.head = (filter.head + 1) % BATTERY_FILTER_WINDOW;
+
+    if (filter.count < BATTERY_FILTER_WINDOW) {
+        filter.count++;
+    }
+
+    uint8_t median = filter.count == BATTERY_FILTER_WINDOW ? battery_filter_median() : raw;
+
+    if (filter.count == 1) {
+        filter.iir_q8 = median << 8;
+    } else {
+        // Round the step to nearest in both directions. Right shifting the negative difference
+        // would round falling levels down instead.
+        int32_t delta = (median << 8) - filter.iir_q8;
+        int32_t step = (abs(delta) + (BIT(CONFIG_ZMK_BATTERY_FILTER_SHIFT) >> 1)) >>
+                       CONFIG_ZMK_BATTERY_FILTER_SHIFT;
+
+        filter.iir_q8 += delta < 0 ? -step : step;
+    }
+
+    return (filter.iir_q8 + 128) >> 8;
+}
+
+static bool battery_should_report(uint8_t state_of_charge) {
+    if (!state_of_charge_reported) {
+        return true;
+    }
+
+    if (state_of_charge == last_state_of_charge) {
+        return false;
+    }
+
+    // Always let the filtered value settle on the ends of the range, even if the step is small.
+    if (state_of_charge == 0 || state_of_charge == 100) {
+        return true;
+    }
+
+    return abs(state_of_charge - last_state_of_charge) >= CONFIG_ZMK_BATTERY_REPORT_MIN_DELTA;
+}
+
+static uint32_t battery_next_interval(void) {
+    if (fast_samples_remaining > 0) {
+        fast_samples_remaining--;
+        return CONFIG_ZMK_BATTERY_REPORT_INTERVAL_CHARGING;
+    }
+
+    if (zmk_activity_get_state() == ZMK_ACTIVITY_ACTIVE) {
+        sample_interval = CONFIG_ZMK_BATTERY_REPORT_INTERVAL;
+    } else {
+        sample_interval = MIN(sample_interval * 2, CONFIG_ZMK_BATTERY_REPORT_INTERVAL_IDLE_MAX);
+    }
+
+    return sample_interval;
+}
+
+#endif /* IS_ENABLED(CONFIG_ZMK_BATTERY_ADAPTIVE_SAMPLING) */
+
 static int zmk_battery_update(const struct device *battery) {
     struct sensor_value state_of_charge;
 
@@ -51,8 +150,18 @@ static int zmk_battery_update(const struct device *battery) {
         return rc;
     }
 
+#if IS_ENABLED(CONFIG_ZMK_BATTERY_ADAPTIVE_SAMPLING)
+    uint8_t filtered = battery_filter_apply(state_of_charge.val1);
+
+    LOG_DBG("Battery raw %d%% filtered %d%%", state_of_charge.val1, filtered);
+
+    if (battery_should_report(filtered)) {
+        state_of_charge_reported = true;
+        last_state_of_charge = filtered;
+#else
     if (last_state_of_charge != state_of_charge.val1) {
         last_state_of_charge = state_of_charge.val1;
+#endif
 #if IS_ENABLED(CONFIG_BT_BAS)
         LOG_DBG("Setting BAS GATT battery level to %d.", last_state_of_charge);
 
@@ -70,12 +179,22 @@ static int zmk_battery_update(const struct device *battery) {
     return rc;
 }
 
+static void zmk_battery_timer(struct k_timer *timer);
+
+K_TIMER_DEFINE(battery_timer, zmk_battery_timer, NULL);
+
 static void zmk_battery_work(struct k_work *work) {
     int rc = zmk_battery_update(battery);
 
     if (rc != 0) {
         LOG_DBG("Failed to update battery value: %d.", rc);
     }
+
+#if IS_ENABLED(CONFIG_ZMK_BATTERY_ADAPTIVE_SAMPLING)
+    if (zmk_activity_get_state() != ZMK_ACTIVITY_SLEEP) {
+        k_timer_start(&battery_timer, K_SECONDS(battery_next_interval()), K_NO_WAIT);
+    }
+#endif
 }
 
 K_WORK_DEFINE(battery_work, zmk_battery_work);
@@ -84,11 +203,14 @@ static void zmk_battery_timer(struct k_timer *timer) {
     k_work_submit_to_queue(zmk_workqueue_lowprio_work_q(), &battery_work);
 }
 
-K_TIMER_DEFINE(battery_timer, zmk_battery_timer, NULL);
-
 static void zmk_battery_start_reporting() {
     if (device_is_ready(battery)) {
+#if IS_ENABLED(CONFIG_ZMK_BATTERY_ADAPTIVE_SAMPLING)
+        // One-shot; the work handler picks the next interval after each sample.
+        k_timer_start(&battery_timer, K_NO_WAIT, K_NO_WAIT);
+#else
         k_timer_start(&battery_timer, K_NO_WAIT, K_SECONDS(CONFIG_ZMK_BATTERY_REPORT_INTERVAL));
+#endif
     }
 }
 
@@ -119,7 +241,13 @@ static int battery_event_listener(const zmk_event_t *eh) {
         case ZMK_ACTIVITY_ACTIVE:
             zmk_battery_start_reporting();
             return 0;
+#if IS_ENABLED(CONFIG_ZMK_BATTERY_ADAPTIVE_SAMPLING)
+        case ZMK_ACTIVITY_IDLE:
+            // Keep sampling, backing off from the next sample onwards.
+            return 0;
+#else
         case ZMK_ACTIVITY_IDLE:
+#endif
         case ZMK_ACTIVITY_SLEEP:
             k_timer_stop(&battery_timer);
             return 0;
@@ -127,11 +255,34 @@ static int battery_event_listener(const zmk_event_t *eh) {
             break;
         }
     }
+
+#if IS_ENABLED(CONFIG_ZMK_BATTERY_ADAPTIVE_SAMPLING) && IS_ENABLED(CONFIG_USB_DEVICE_STACK)
+    if (as_zmk_usb_conn_state_changed(eh)) {
+        static bool usb_powered = false;
+
+        if (zmk_usb_is_powered() == usb_powered) {
+            return 0;
+        }
+
+        usb_powered = zmk_usb_is_powered();
+
+        // The cell voltage steps when charging starts or stops, so drop the filter history and
+        // track the transition closely for a while.
+        battery_filter_reset();
+        fast_samples_remaining = CONFIG_ZMK_BATTERY_CHARGING_FAST_SAMPLES;
+        zmk_battery_start_reporting();
+        return 0;
+    }
+#endif
+
     return -ENOTSUP;
 }
 
 ZMK_LISTENER(battery, battery_event_listener);
 
 ZMK_SUBSCRIPTION(battery, zmk_activity_state_changed);
+#if IS_ENABLED(CONFIG_ZMK_BATTERY_ADAPTIVE_SAMPLING) && IS_ENABLED(CONFIG_USB_DEVICE_STACK)
+ZMK_SUBSCRIPTION(battery, zmk_usb_conn_state_changed);
+#endif
 
 SYS_INIT(zmk_battery_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -9,7 +9,9 @@
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include <drivers/behavior.h>
+#include <zmk/hid_listener.h>
 #include <zmk/split/bluetooth/central.h>
+#include <zmk/workqueue.h>
 
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
@@ -29,6 +31,9 @@ static K_WORK_DELAYABLE_DEFINE(queue_work, behavior_queue_process_next);
 static void behavior_queue_process_next(struct k_work *work) {
     struct q_item item = {.wait = 0};
 
+    // Behaviors queued without a wait between them share one report per usage page.
+    zmk_hid_listener_batch_begin();
+
     while (k_msgq_get(&zmk_behavior_queue_msgq, &item, K_NO_WAIT) == 0) {
         LOG_DBG("Invoking %s: 0x%02x 0x%02x", item.binding.behavior_dev, item.binding.param1,
                 item.binding.param2);
@@ -47,10 +52,12 @@ static void behavior_queue_process_next(struct k_work *work) {
         LOG_DBG("Processing next queued behavior in %dms", item.wait);
 
         if (item.wait > 0) {
-            k_work_schedule(&queue_work, K_MSEC(item.wait));
+            k_work_schedule_for_queue(zmk_workqueue_input_work_q(), &queue_work, K_MSEC(item.wait));
             break;
         }
     }
+
+    zmk_hid_listener_batch_end();
 }
 
 int zmk_behavior_queue_add(uint32_t position, const struct zmk_behavior_binding binding, bool press,
@@ -68,3 +75,7 @@ int zmk_behavior_queue_add(uint32_t position, const struct zmk_behavior_binding
 
     return 0;
 }
+
+uint32_t zmk_behavior_queue_free_slots(void) {
+    return k_msgq_num_free_get(&zmk_behavior_queue_msgq);
+}
@@ -13,6 +13,7 @@
 #include <zephyr/sys/util.h> // CLAMP
 
 #include <zmk/behavior.h>
+#include <zmk/workqueue.h>
 #include <dt-bindings/zmk/mouse.h>
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
@@ -165,7 +166,8 @@ static void tick_work_cb(struct k_work *work) {
     }
 
     if (should_be_working(data)) {
-        k_work_schedule(&data->tick_work, K_MSEC(cfg->trigger_period_ms));
+        k_work_schedule_for_queue(zmk_workqueue_input_work_q(), &data->tick_work,
+                                  K_MSEC(cfg->trigger_period_ms));
     }
 }
 
@@ -188,7 +190,8 @@ static void update_work_scheduling(const struct device *dev) {
     set_start_times_for_activity(&data->state);
 
     if (should_be_working(data)) {
-        k_work_schedule(&data->tick_work, K_MSEC(cfg->trigger_period_ms));
+        k_work_schedule_for_queue(zmk_workqueue_input_work_q(), &data->tick_work,
+                                  K_MSEC(cfg->trigger_period_ms));
     } else {
         k_work_cancel_delayable(&data->tick_work);
     }
@@ -9,6 +9,7 @@
 #include <zephyr/logging/log.h>
 #include <zmk/behavior.h>
 #include <zmk/behavior_queue.h>
+#include <zmk/hid_listener.h>
 #include <zmk/keymap.h>
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
@@ -158,6 +159,8 @@ static void queue_macro(uint32_t position, const struct zmk_behavior_binding bin
                         struct behavior_macro_trigger_state state,
                         const struct zmk_behavior_binding *macro_binding) {
     LOG_DBG("Iterating macro bindings - starting: %d, count: %d", state.start_index, state.count);
+    // Bindings that run right away because there is no wait before them send one report.
+    zmk_hid_listener_batch_begin();
     for (int i = state.start_index; i < state.start_index + state.count; i++) {
         if (!handle_control_binding(&state, &bindings[i])) {
             struct zmk_behavior_binding binding = bindings[i];
@@ -180,6 +183,7 @@ static void queue_macro(uint32_t position, const struct zmk_behavior_binding bin
             }
         }
     }
+    zmk_hid_listener_batch_end();
 }
 
 static int on_macro_binding_pressed(struct zmk_behavior_binding *binding,
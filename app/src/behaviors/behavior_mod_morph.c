@@ -18,6 +18,7 @@
 #include <zmk/events/keycode_state_changed.h>
 #include <zmk/events/modifiers_state_changed.h>
 #include <zmk/hid.h>
+#include <zmk/hid_listener.h>
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
@@ -51,7 +52,12 @@ static int on_mod_morph_binding_pressed(struct zmk_behavior_binding *binding,
     } else {
         data->pressed_binding = (struct zmk_behavior_binding *)&cfg->normal_binding;
     }
-    return behavior_keymap_binding_pressed(data->pressed_binding, event);
+
+    // A morph binding that changes several usages, such as a macro, sends one report for them.
+    zmk_hid_listener_batch_begin();
+    int err = behavior_keymap_binding_pressed(data->pressed_binding, event);
+    zmk_hid_listener_batch_end();
+    return err;
 }
 
 static int on_mod_morph_binding_released(struct zmk_behavior_binding *binding,
@@ -66,8 +72,9 @@ static int on_mod_morph_binding_released(struct zmk_behavior_binding *binding,
 
     struct zmk_behavior_binding *pressed_binding = data->pressed_binding;
     data->pressed_binding = NULL;
-    int err;
-    err = behavior_keymap_binding_released(pressed_binding, event);
+    zmk_hid_listener_batch_begin();
+    int err = behavior_keymap_binding_released(pressed_binding, event);
+    zmk_hid_listener_batch_end();
     zmk_hid_masked_modifiers_clear();
     return err;
 }
@@ -16,8 +16,6 @@ static const struct behavior_driver_api behavior_sensor_rotate_driver_api = {
     .sensor_binding_accept_data = zmk_behavior_sensor_rotate_common_accept_data,
     .sensor_binding_process = zmk_behavior_sensor_rotate_common_process};
 
-static int behavior_sensor_rotate_init(const struct device *dev) { return 0; };
-
 #define _TRANSFORM_ENTRY(idx, node)                                                                \
     {                                                                                              \
         .behavior_dev = DEVICE_DT_NAME(DT_INST_PHANDLE_BY_IDX(node, bindings, idx)),               \
@@ -35,7 +33,7 @@ static int behavior_sensor_rotate_init(const struct device *dev) { return 0; };
         .override_params = false,                                                                  \
     };                                                                                             \
     static struct behavior_sensor_rotate_data behavior_sensor_rotate_data_##n = {};                \
-    BEHAVIOR_DT_INST_DEFINE(n, behavior_sensor_rotate_init, NULL,                                  \
+    BEHAVIOR_DT_INST_DEFINE(n, zmk_behavior_sensor_rotate_common_init, NULL,                       \
                             &behavior_sensor_rotate_data_##n, &behavior_sensor_rotate_config_##n,  \
                             POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,                      \
                             &behavior_sensor_rotate_driver_api);
@@ -6,6 +6,7 @@
 
 #include <zmk/behavior_queue.h>
 #include <zmk/virtual_key_position.h>
+#include <zmk/workqueue.h>
 
 #include "behavior_sensor_rotate_common.h"
 
@@ -55,6 +56,73 @@ int zmk_behavior_sensor_rotate_common_accept_data(
     return 0;
 }
 
+// Carried triggers are retried once the sensor batch window, or at least one tap, has passed.
+static k_timeout_t carry_window(const struct behavior_sensor_rotate_config *cfg) {
+    return K_MSEC(MAX(CONFIG_ZMK_KEYMAP_SENSORS_BATCH_MS, cfg->tap_ms));
+}
+
+// Taps as many of the carried triggers as fit in the behavior queue, and leaves the rest carried.
+static void tap_carried_triggers(const struct behavior_sensor_rotate_config *cfg,
+                                 struct behavior_sensor_rotate_carry *carry) {
+    struct zmk_behavior_binding triggered_binding;
+    int triggers = carry->triggers;
+
+    if (triggers > 0) {
+        triggered_binding = cfg->cw_binding;
+        if (cfg->override_params) {
+            triggered_binding.param1 = carry->binding.param1;
+        }
+    } else if (triggers < 0) {
+        triggers = -triggers;
+        triggered_binding = cfg->ccw_binding;
+        if (cfg->override_params) {
+            triggered_binding.param1 = carry->binding.param2;
+        }
+    } else {
+        return;
+    }
+
+    // Each trigger takes a press and a release slot in the behavior queue.
+    int taps = MIN(triggers, zmk_behavior_queue_free_slots() / 2);
+
+    LOG_DBG("Sensor binding: %s", carry->binding.behavior_dev);
+
+    for (int i = 0; i < taps; i++) {
+        zmk_behavior_queue_add(carry->position, triggered_binding, true, cfg->tap_ms);
+        zmk_behavior_queue_add(carry->position, triggered_binding, false, 0);
+    }
+
+    carry->triggers += carry->triggers > 0 ? -taps : taps;
+}
+
+static void carry_work_callback(struct k_work *work) {
+    struct k_work_delayable *d_work = k_work_delayable_from_work(work);
+    struct behavior_sensor_rotate_data *data =
+        CONTAINER_OF(d_work, struct behavior_sensor_rotate_data, carry_work);
+    const struct behavior_sensor_rotate_config *cfg = data->dev->config;
+    bool carrying = false;
+
+    for (int i = 0; i < ZMK_KEYMAP_SENSORS_LEN; i++) {
+        for (int j = 0; j < ZMK_KEYMAP_LAYERS_LEN; j++) {
+            tap_carried_triggers(cfg, &data->carry[i][j]);
+            carrying |= data->carry[i][j].triggers != 0;
+        }
+    }
+
+    if (carrying) {
+        k_work_schedule_for_queue(zmk_workqueue_input_work_q(), &data->carry_work,
+                                  carry_window(cfg));
+    }
+}
+
+int zmk_behavior_sensor_rotate_common_init(const struct device *dev) {
+    struct behavior_sensor_rotate_data *data = dev->data;
+
+    data->dev = dev;
+    k_work_init_delayable(&data->carry_work, carry_work_callback);
+    return 0;
+}
+
 int zmk_behavior_sensor_rotate_common_process(struct zmk_behavior_binding *binding,
                                               struct zmk_behavior_binding_event event,
                                               enum behavior_sensor_binding_process_mode mode) {
@@ -70,28 +138,25 @@ int zmk_behavior_sensor_rotate_common_process(struct zmk_behavior_binding *bindi
     }
 
     int triggers = data->triggers[sensor_index][event.layer];
-
-    struct zmk_behavior_binding triggered_binding;
-    if (triggers > 0) {
-        triggered_binding = cfg->cw_binding;
-        if (cfg->override_params) {
-            triggered_binding.param1 = binding->param1;
-        }
-    } else if (triggers < 0) {
-        triggers = -triggers;
-        triggered_binding = cfg->ccw_binding;
-        if (cfg->override_params) {
-            triggered_binding.param1 = binding->param2;
-        }
-    } else {
+    if (triggers == 0) {
         return ZMK_BEHAVIOR_TRANSPARENT;
     }
 
-    LOG_DBG("Sensor binding: %s", binding->behavior_dev);
-
-    for (int i = 0; i < triggers; i++) {
-        zmk_behavior_queue_add(event.position, triggered_binding, true, cfg->tap_ms);
-        zmk_behavior_queue_add(event.position, triggered_binding, false, 0);
+    // Triggers still carried from an earlier event are tapped first. Turning the other way
+    // cancels them out instead, since the host never saw them.
+    struct behavior_sensor_rotate_carry *carry = &data->carry[sensor_index][event.layer];
+    carry->binding = *binding;
+    carry->position = event.position;
+    carry->triggers += triggers;
+
+    tap_carried_triggers(cfg, carry);
+
+    // A batched sensor event can carry more detents than fit in the behavior queue at once, so
+    // the rest is tapped in the next window instead of being dropped.
+    if (carry->triggers != 0) {
+        LOG_DBG("Carrying %d sensor triggers over to the next window", carry->triggers);
+        k_work_schedule_for_queue(zmk_workqueue_input_work_q(), &data->carry_work,
+                                  carry_window(cfg));
     }
 
     return ZMK_BEHAVIOR_OPAQUE;
@@ -16,11 +16,24 @@ struct behavior_sensor_rotate_config {
     bool override_params;
 };
 
+// Triggers that did not fit in the behavior queue yet, with the binding and position to tap them
+// for. Positive counts are clockwise.
+struct behavior_sensor_rotate_carry {
+    struct zmk_behavior_binding binding;
+    uint32_t position;
+    int triggers;
+};
+
 struct behavior_sensor_rotate_data {
     struct sensor_value remainder[ZMK_KEYMAP_SENSORS_LEN][ZMK_KEYMAP_LAYERS_LEN];
     int triggers[ZMK_KEYMAP_SENSORS_LEN][ZMK_KEYMAP_LAYERS_LEN];
+    struct behavior_sensor_rotate_carry carry[ZMK_KEYMAP_SENSORS_LEN][ZMK_KEYMAP_LAYERS_LEN];
+    struct k_work_delayable carry_work;
+    const struct device *dev;
 };
 
+int zmk_behavior_sensor_rotate_common_init(const struct device *dev);
+
 int zmk_behavior_sensor_rotate_common_accept_data(
     struct zmk_behavior_binding *binding, struct zmk_behavior_binding_event event,
     const struct zmk_sensor_config *sensor_config, size_t channel_data_size,
@@ -16,8 +16,6 @@ static const struct behavior_driver_api behavior_sensor_rotate_var_driver_api =
     .sensor_binding_accept_data = zmk_behavior_sensor_rotate_common_accept_data,
     .sensor_binding_process = zmk_behavior_sensor_rotate_common_process};
 
-static int behavior_sensor_rotate_var_init(const struct device *dev) { return 0; };
-
 #define SENSOR_ROTATE_VAR_INST(n)                                                                  \
     static struct behavior_sensor_rotate_config behavior_sensor_rotate_var_config_##n = {          \
         .cw_binding = {.behavior_dev = DEVICE_DT_NAME(DT_INST_PHANDLE_BY_IDX(n, bindings, 0))},    \
@@ -27,7 +25,7 @@ static int behavior_sensor_rotate_var_init(const struct device *dev) { return 0;
     };                                                                                             \
     static struct behavior_sensor_rotate_data behavior_sensor_rotate_var_data_##n = {};            \
     BEHAVIOR_DT_INST_DEFINE(                                                                       \
-        n, behavior_sensor_rotate_var_init, NULL, &behavior_sensor_rotate_var_data_##n,            \
+        n, zmk_behavior_sensor_rotate_common_init, NULL, &behavior_sensor_rotate_var_data_##n,     \
         &behavior_sensor_rotate_var_config_##n, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,  \
         &behavior_sensor_rotate_var_driver_api);
 
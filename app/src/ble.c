@@ -35,6 +35,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/keys.h>
 #include <zmk/split/bluetooth/uuid.h>
 #include <zmk/event_manager.h>
+#include <zmk/workqueue.h>
 #include <zmk/events/ble_active_profile_changed.h>
 
 #if IS_ENABLED(CONFIG_ZMK_BLE_PASSKEY_ENTRY)
@@ -76,11 +77,11 @@ static const struct bt_data zmk_ble_ad[] = {
                   ),
 };
 
-#if IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+#if ZMK_BLE_IS_CENTRAL
 
 static bt_addr_le_t peripheral_addrs[ZMK_SPLIT_BLE_PERIPHERAL_COUNT];
 
-#endif /* IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL) */
+#endif /* ZMK_BLE_IS_CENTRAL */
 
 static void raise_profile_changed_event(void) {
     raise_zmk_ble_active_profile_changed((struct zmk_ble_active_profile_changed){
@@ -109,7 +110,7 @@ void set_profile_address(uint8_t index, const bt_addr_le_t *addr) {
 #if IS_ENABLED(CONFIG_SETTINGS)
     settings_save_one(setting_name, &profiles[index], sizeof(struct zmk_ble_profile));
 #endif
-    k_work_submit(&raise_profile_changed_event_work);
+    k_work_submit_to_queue(zmk_workqueue_input_work_q(), &raise_profile_changed_event_work);
 }
 
 bool zmk_ble_active_profile_is_connected(void) {
@@ -320,7 +321,7 @@ bt_addr_le_t *zmk_ble_active_profile_addr(void) { return &profiles[active_profil
 
 char *zmk_ble_active_profile_name(void) { return profiles[active_profile].name; }
 
-#if IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+#if ZMK_BLE_IS_CENTRAL
 
 int zmk_ble_put_peripheral_addr(const bt_addr_le_t *addr) {
     for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
@@ -357,7 +358,7 @@ int zmk_ble_put_peripheral_addr(const bt_addr_le_t *addr) {
     return -ENOMEM;
 }
 
-#endif /* IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL) */
+#endif /* ZMK_BLE_IS_CENTRAL */
 
 #if IS_ENABLED(CONFIG_SETTINGS)
 
@@ -408,7 +409,7 @@ static int ble_profiles_handle_set(const char *name, size_t len, settings_read_c
             return err;
         }
     }
-#if IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+#if ZMK_BLE_IS_CENTRAL
     else if (settings_name_steq(name, "peripheral_addresses", &next) && next) {
         if (len != sizeof(bt_addr_le_t)) {
             return -EINVAL;
@@ -464,7 +465,7 @@ static void connected(struct bt_conn *conn, uint8_t err) {
 
     if (is_conn_active_profile(conn)) {
         LOG_DBG("Active profile connected");
-        k_work_submit(&raise_profile_changed_event_work);
+        k_work_submit_to_queue(zmk_workqueue_input_work_q(), &raise_profile_changed_event_work);
     }
 }
 
@@ -489,7 +490,7 @@ static void disconnected(struct bt_conn *conn, uint8_t reason) {
 
     if (is_conn_active_profile(conn)) {
         LOG_DBG("Active profile disconnected");
-        k_work_submit(&raise_profile_changed_event_work);
+        k_work_submit_to_queue(zmk_workqueue_input_work_q(), &raise_profile_changed_event_work);
     }
 }
 
@@ -21,6 +21,7 @@
 #include <zmk/matrix.h>
 #include <zmk/keymap.h>
 #include <zmk/virtual_key_position.h>
+#include <zmk/workqueue.h>
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
@@ -38,8 +39,10 @@ struct combo_cfg {
     // the virtual key position is a key position outside the range used by the keyboard.
     // it is necessary so hold-taps can uniquely identify a behavior.
     int32_t virtual_key_position;
+    // the layers this combo is active on, derived from `layers` when the combo is initialized.
+    zmk_keymap_layers_state_t layers_state;
     int32_t layers_len;
-    int8_t layers[];
+    int16_t layers[];
 };
 
 struct active_combo {
@@ -91,6 +94,15 @@ static void store_last_tapped(int64_t timestamp) {
 // Store the combo key pointer in the combos array, one pointer for each key position
 // The combos are sorted shortest-first, then by virtual-key-position.
 static int initialize_combo(struct combo_cfg *new_combo) {
+    for (int i = 0; i < ZMK_KEYMAP_LAYERS_LEN; i++) {
+        // -1 in the first layer position is global layer scope
+        bool active = new_combo->layers[0] == -1;
+        for (int j = 0; !active && j < new_combo->layers_len; j++) {
+            active = new_combo->layers[j] == i;
+        }
+        new_combo->layers_state = zmk_keymap_layers_state_write(new_combo->layers_state, i, active);
+    }
+
     for (int i = 0; i < new_combo->key_position_len; i++) {
         int32_t position = new_combo->key_positions[i];
         if (position >= ZMK_KEYMAP_LEN) {
@@ -126,16 +138,7 @@ static int initialize_combo(struct combo_cfg *new_combo) {
 }
 
 static bool combo_active_on_layer(struct combo_cfg *combo, uint8_t layer) {
-    if (combo->layers[0] == -1) {
-        // -1 in the first layer position is global layer scope
-        return true;
-    }
-    for (int j = 0; j < combo->layers_len; j++) {
-        if (combo->layers[j] == layer) {
-            return true;
-        }
-    }
-    return false;
+    return zmk_keymap_layers_state_test(combo->layers_state, layer);
 }
 
 static bool is_quick_tap(struct combo_cfg *combo, int64_t timestamp) {
@@ -414,7 +417,8 @@ static void update_timeout_task() {
         k_work_cancel_delayable(&timeout_task);
         return;
     }
-    if (k_work_schedule(&timeout_task, K_MSEC(first_timeout - k_uptime_get())) >= 0) {
+    if (k_work_schedule_for_queue(zmk_workqueue_input_work_q(), &timeout_task,
+                                  K_MSEC(first_timeout - k_uptime_get())) >= 0) {
         timeout_task_timeout_at = first_timeout;
     }
 }
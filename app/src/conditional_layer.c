@@ -8,37 +8,35 @@
 
 #include <stdint.h>
 #include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
 
 #include <zephyr/devicetree.h>
 #include <zephyr/logging/log.h>
 
-#include <zmk/event_manager.h>
 #include <zmk/keymap.h>
-#include <zmk/events/layer_state_changed.h>
+#include <zmk/conditional_layer.h>
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #if DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT)
 
-static K_SEM_DEFINE(conditional_layer_sem, 1, 1);
-
 // Conditional layer configuration that activates the specified then-layer when all if-layers are
 // active. With two if-layers, this is referred to as "tri-layer", and is commonly used to activate
 // a third "adjust" layer if and only if the "lower" and "raise" layers are both active.
 struct conditional_layer_cfg {
-    // A bitmask of each layer that must be pressed for this conditional layer config to activate.
+    // Each layer that must be pressed for this conditional layer config to activate, built from the
+    // if-layers property at compile time.
     zmk_keymap_layers_state_t if_layers_state_mask;
 
     // The layer number that should be active while all layers in the if-layers mask are active.
-    int8_t then_layer;
+    uint8_t then_layer;
 };
 
-#define IF_LAYER_BIT(node_id, prop, idx) BIT(DT_PROP_BY_IDX(node_id, prop, idx)) |
-
 // Evaluates to conditional_layer_cfg struct initializer.
 #define CONDITIONAL_LAYER_DECL(n)                                                                  \
     {                                                                                              \
-        .if_layers_state_mask = DT_FOREACH_PROP_ELEM(n, if_layers, IF_LAYER_BIT) 0,                \
+        .if_layers_state_mask =                                                                    \
+            ZMK_KEYMAP_LAYERS_STATE_INIT(ZMK_KEYMAP_LAYERS_STATE_PROP_WORD, n, if_layers),         \
         .then_layer = DT_PROP(n, then_layer),                                                      \
     },
 
@@ -49,76 +47,55 @@ static const struct conditional_layer_cfg CONDITIONAL_LAYER_CFGS[] = {
 static const int32_t NUM_CONDITIONAL_LAYER_CFGS =
     sizeof(CONDITIONAL_LAYER_CFGS) / sizeof(*CONDITIONAL_LAYER_CFGS);
 
-static void conditional_layer_activate(int8_t layer) {
-    // This may trigger another event that could, in turn, activate additional then-layers. However,
-    // the process will eventually terminate (at worst, when every layer is active).
-    if (!zmk_keymap_layer_active(layer)) {
-        LOG_DBG("layer %d", layer);
-        zmk_keymap_layer_activate(layer);
-    }
-}
-
-static void conditional_layer_deactivate(int8_t layer) {
-    // This may deactivate a then-layer that's already active via another mechanism (e.g., a
-    // momentary layer behavior). However, the same problem arises when multiple keys with the same
-    // &mo binding are held and then one is released, so it's probably not an issue in practice.
-    if (zmk_keymap_layer_active(layer)) {
-        LOG_DBG("layer %d", layer);
-        zmk_keymap_layer_deactivate(layer);
-    }
-}
-
-static int layer_state_changed_listener(const zmk_event_t *ev) {
-    static bool conditional_layer_updates_needed;
+// Word function for the then-layers of all configurations.
+#define THEN_LAYER_OR(n, word) | ZMK_KEYMAP_LAYERS_STATE_LAYER_WORD(DT_PROP(n, then_layer), word)
+#define THEN_LAYERS_WORD(word, ...) (0 DT_INST_FOREACH_CHILD_VARGS(0, THEN_LAYER_OR, word))
 
-    conditional_layer_updates_needed = true;
+// Every layer that is controlled by at least one conditional layer configuration.
+static const zmk_keymap_layers_state_t then_layers_state_mask =
+    ZMK_KEYMAP_LAYERS_STATE_INIT(THEN_LAYERS_WORD);
 
-    // Semaphore ensures we don't re-enter the loop in the middle of doing update, and
-    // ensures that "waterfalling layer updates" are all processed to trigger subsequent
-    // nested conditional layers properly.
-    if (k_sem_take(&conditional_layer_sem, K_NO_WAIT) < 0) {
-        return 0;
-    }
-
-    while (conditional_layer_updates_needed) {
-        int8_t max_then_layer = -1;
-        uint32_t then_layers = 0;
-        uint32_t then_layer_state = 0;
+zmk_keymap_layers_state_t zmk_conditional_layer_apply(zmk_keymap_layers_state_t state,
+                                                      uint8_t default_layer) {
+    // The default layer is always active, so it is never cleared even when it is a then-layer.
+    const zmk_keymap_layers_state_t clearable =
+        zmk_keymap_layers_state_write(then_layers_state_mask, default_layer, false);
 
-        conditional_layer_updates_needed = false;
+    // Activating a then-layer can satisfy the if-layers of another config, so iterate until the
+    // state settles. Each pass resolves at least one more link of a chain, and bounding the passes
+    // keeps a cyclic configuration from spinning forever.
+    for (int pass = 0; pass <= NUM_CONDITIONAL_LAYER_CFGS; pass++) {
+        zmk_keymap_layers_state_t then_layer_state = {0};
 
-        // On layer state changes, examines each conditional layer config to determine if then-layer
-        // in the config should activate based on the currently active set of if-layers.
         for (int i = 0; i < NUM_CONDITIONAL_LAYER_CFGS; i++) {
             const struct conditional_layer_cfg *cfg = CONDITIONAL_LAYER_CFGS + i;
-            zmk_keymap_layers_state_t mask = cfg->if_layers_state_mask;
-            then_layers |= BIT(cfg->then_layer);
-            max_then_layer = MAX(max_then_layer, cfg->then_layer);
-
-            // Activate then-layer if and only if all if-layers are already active. Note that we
-            // reevaluate the current layer state for each config since activation of one layer can
-            // also trigger activation of another.
-            if ((zmk_keymap_layer_state() & mask) == mask) {
-                then_layer_state |= BIT(cfg->then_layer);
+
+            if (zmk_keymap_layers_state_contains(state, cfg->if_layers_state_mask)) {
+                then_layer_state =
+                    zmk_keymap_layers_state_write(then_layer_state, cfg->then_layer, true);
             }
         }
 
-        for (uint8_t layer = 0; layer <= max_then_layer; layer++) {
-            if ((BIT(layer) & then_layers) != 0U) {
-                if ((BIT(layer) & then_layer_state) != 0U) {
-                    conditional_layer_activate(layer);
-                } else {
-                    conditional_layer_deactivate(layer);
-                }
+        zmk_keymap_layers_state_t next_state =
+            zmk_keymap_layers_state_or(zmk_keymap_layers_state_and_not(state, clearable),
+                                       zmk_keymap_layers_state_and(then_layer_state, clearable));
+        if (zmk_keymap_layers_state_equal(next_state, state)) {
+            return state;
+        }
+
+        for (uint8_t layer = 0; layer < ZMK_KEYMAP_LAYERS_LEN; layer++) {
+            bool active = zmk_keymap_layers_state_test(next_state, layer);
+
+            if (active != zmk_keymap_layers_state_test(state, layer)) {
+                LOG_DBG("%s layer %d", active ? "activate" : "deactivate", layer);
             }
         }
+
+        state = next_state;
     }
 
-    k_sem_give(&conditional_layer_sem);
-    return 0;
+    LOG_WRN("Conditional layers did not settle, check for cyclic configurations");
+    return state;
 }
 
-ZMK_LISTENER(conditional_layer, layer_state_changed_listener);
-ZMK_SUBSCRIPTION(conditional_layer, zmk_layer_state_changed);
-
 #endif
@@ -8,6 +8,7 @@
 #include <zephyr/settings/settings.h>
 
 #include <stdio.h>
+#include <string.h>
 
 #include <zmk/ble.h>
 #include <zmk/endpoints.h>
@@ -31,6 +32,8 @@ static enum zmk_transport preferred_transport =
     ZMK_TRANSPORT_USB; /* Used if multiple endpoints are ready */
 
 static void update_current_endpoint(void);
+static bool is_usb_ready(void);
+static bool is_ble_ready(void);
 
 #if IS_ENABLED(CONFIG_SETTINGS)
 static void endpoints_save_preferred_work(struct k_work *work) {
@@ -120,8 +123,108 @@ struct zmk_endpoint_instance zmk_endpoints_selected(void) {
     return current_instance;
 }
 
-static int send_keyboard_report(void) {
-    switch (current_instance.transport) {
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_STATS)
+static struct zmk_endpoint_stats endpoint_stats[ZMK_ENDPOINT_COUNT];
+static struct k_spinlock endpoint_stats_lock;
+
+int zmk_endpoints_get_stats(struct zmk_endpoint_instance endpoint,
+                            struct zmk_endpoint_stats *stats) {
+    k_spinlock_key_t key = k_spin_lock(&endpoint_stats_lock);
+    *stats = endpoint_stats[zmk_endpoint_instance_to_index(endpoint)];
+    k_spin_unlock(&endpoint_stats_lock, key);
+    return 0;
+}
+
+void zmk_endpoints_record_sent(struct zmk_endpoint_instance endpoint, uint32_t latency_us) {
+    k_spinlock_key_t key = k_spin_lock(&endpoint_stats_lock);
+    struct zmk_endpoint_stats *stats = &endpoint_stats[zmk_endpoint_instance_to_index(endpoint)];
+    stats->sent++;
+    stats->last_latency_us = latency_us;
+    stats->max_latency_us = MAX(stats->max_latency_us, latency_us);
+    k_spin_unlock(&endpoint_stats_lock, key);
+}
+
+void zmk_endpoints_record_dropped(struct zmk_endpoint_instance endpoint) {
+    k_spinlock_key_t key = k_spin_lock(&endpoint_stats_lock);
+    endpoint_stats[zmk_endpoint_instance_to_index(endpoint)].dropped++;
+    k_spin_unlock(&endpoint_stats_lock, key);
+}
+
+static void record_transport_result(struct zmk_endpoint_instance endpoint, int err,
+                                    uint32_t start_cycles) {
+    if (err) {
+        zmk_endpoints_record_dropped(endpoint);
+    } else if (endpoint.transport == ZMK_TRANSPORT_USB) {
+        // BLE reports are only queued here; HOG records them once they are notified.
+        zmk_endpoints_record_sent(endpoint, k_cyc_to_us_floor32(k_cycle_get_32() - start_cycles));
+    }
+}
+#endif // IS_ENABLED(CONFIG_ZMK_ENDPOINTS_STATS)
+
+/**
+ * Gets the endpoint instances that reports should be sent to. In mirror mode that is every
+ * connected transport, with BLE first since queueing its reports never blocks.
+ */
+static int get_report_targets(struct zmk_endpoint_instance *targets) {
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_MIRROR)
+    int count = 0;
+
+    if (is_ble_ready()) {
+        targets[count++] = (struct zmk_endpoint_instance){
+            .transport = ZMK_TRANSPORT_BLE,
+            .ble = {.profile_index = zmk_ble_active_profile_index()},
+        };
+    }
+    if (is_usb_ready()) {
+        targets[count++] = (struct zmk_endpoint_instance){.transport = ZMK_TRANSPORT_USB};
+    }
+    if (count > 0) {
+        return count;
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_ENDPOINTS_MIRROR)
+
+    targets[0] = current_instance;
+    return 1;
+}
+
+#define MAX_REPORT_TARGETS COND_CODE_1(IS_ENABLED(CONFIG_ZMK_ENDPOINTS_MIRROR), (2), (1))
+
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_SKIP_DUPLICATE_REPORTS)
+// Last report handed to each endpoint instance, used to skip sending identical reports. Transports
+// that only queue the report invalidate it if the queued report is later dropped or fails.
+struct endpoint_reports {
+    struct zmk_hid_keyboard_report_body keyboard;
+    struct zmk_hid_consumer_report_body consumer;
+    bool keyboard_sent;
+    bool consumer_sent;
+};
+
+static struct endpoint_reports sent_reports[ZMK_ENDPOINT_COUNT];
+
+static void invalidate_sent_reports(void) {
+    for (int i = 0; i < ZMK_ENDPOINT_COUNT; i++) {
+        sent_reports[i].keyboard_sent = false;
+        sent_reports[i].consumer_sent = false;
+    }
+}
+
+void zmk_endpoints_invalidate_sent_report(struct zmk_endpoint_instance endpoint,
+                                          uint16_t usage_page) {
+    struct endpoint_reports *sent = &sent_reports[zmk_endpoint_instance_to_index(endpoint)];
+
+    switch (usage_page) {
+    case HID_USAGE_KEY:
+        sent->keyboard_sent = false;
+        break;
+    case HID_USAGE_CONSUMER:
+        sent->consumer_sent = false;
+        break;
+    }
+}
+#endif // IS_ENABLED(CONFIG_ZMK_ENDPOINTS_SKIP_DUPLICATE_REPORTS)
+
+static int send_keyboard_report_to_transport(struct zmk_endpoint_instance endpoint) {
+    switch (endpoint.transport) {
     case ZMK_TRANSPORT_USB: {
 #if IS_ENABLED(CONFIG_ZMK_USB)
         int err = zmk_usb_hid_send_keyboard_report();
@@ -150,12 +253,40 @@ static int send_keyboard_report(void) {
     }
     }
 
-    LOG_ERR("Unhandled endpoint transport %d", current_instance.transport);
+    LOG_ERR("Unhandled endpoint transport %d", endpoint.transport);
     return -ENOTSUP;
 }
 
-static int send_consumer_report(void) {
-    switch (current_instance.transport) {
+static int send_keyboard_report_to(struct zmk_endpoint_instance endpoint) {
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_SKIP_DUPLICATE_REPORTS)
+    struct endpoint_reports *sent = &sent_reports[zmk_endpoint_instance_to_index(endpoint)];
+    struct zmk_hid_keyboard_report_body *body = &zmk_hid_get_keyboard_report()->body;
+
+    if (sent->keyboard_sent && memcmp(&sent->keyboard, body, sizeof(*body)) == 0) {
+        LOG_DBG("Skipping unchanged keyboard report");
+        return 0;
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_ENDPOINTS_SKIP_DUPLICATE_REPORTS)
+
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_STATS)
+    uint32_t start_cycles = k_cycle_get_32();
+#endif
+    int err = send_keyboard_report_to_transport(endpoint);
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_STATS)
+    record_transport_result(endpoint, err, start_cycles);
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_SKIP_DUPLICATE_REPORTS)
+    if (!err) {
+        memcpy(&sent->keyboard, body, sizeof(*body));
+    }
+    sent->keyboard_sent = !err;
+#endif // IS_ENABLED(CONFIG_ZMK_ENDPOINTS_SKIP_DUPLICATE_REPORTS)
+    return err;
+}
+
+static int send_consumer_report_to_transport(struct zmk_endpoint_instance endpoint) {
+    switch (endpoint.transport) {
     case ZMK_TRANSPORT_USB: {
 #if IS_ENABLED(CONFIG_ZMK_USB)
         int err = zmk_usb_hid_send_consumer_report();
@@ -184,19 +315,63 @@ static int send_consumer_report(void) {
     }
     }
 
-    LOG_ERR("Unhandled endpoint transport %d", current_instance.transport);
+    LOG_ERR("Unhandled endpoint transport %d", endpoint.transport);
     return -ENOTSUP;
 }
 
+static int send_consumer_report_to(struct zmk_endpoint_instance endpoint) {
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_SKIP_DUPLICATE_REPORTS)
+    struct endpoint_reports *sent = &sent_reports[zmk_endpoint_instance_to_index(endpoint)];
+    struct zmk_hid_consumer_report_body *body = &zmk_hid_get_consumer_report()->body;
+
+    if (sent->consumer_sent && memcmp(&sent->consumer, body, sizeof(*body)) == 0) {
+        LOG_DBG("Skipping unchanged consumer report");
+        return 0;
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_ENDPOINTS_SKIP_DUPLICATE_REPORTS)
+
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_STATS)
+    uint32_t start_cycles = k_cycle_get_32();
+#endif
+    int err = send_consumer_report_to_transport(endpoint);
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_STATS)
+    record_transport_result(endpoint, err, start_cycles);
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_SKIP_DUPLICATE_REPORTS)
+    if (!err) {
+        memcpy(&sent->consumer, body, sizeof(*body));
+    }
+    sent->consumer_sent = !err;
+#endif // IS_ENABLED(CONFIG_ZMK_ENDPOINTS_SKIP_DUPLICATE_REPORTS)
+    return err;
+}
+
+// Sends the current report to every target, returning the first error encountered.
+static int send_report_to_targets(int (*send)(struct zmk_endpoint_instance)) {
+    struct zmk_endpoint_instance targets[MAX_REPORT_TARGETS];
+    int count = get_report_targets(targets);
+    int ret = 0;
+
+    for (int i = 0; i < count; i++) {
+        int err = send(targets[i]);
+        if (err && !ret) {
+            ret = err;
+        }
+    }
+
+    return ret;
+}
+
 int zmk_endpoints_send_report(uint16_t usage_page) {
 
     LOG_DBG("usage page 0x%02X", usage_page);
     switch (usage_page) {
     case HID_USAGE_KEY:
-        return send_keyboard_report();
+        return send_report_to_targets(send_keyboard_report_to);
 
     case HID_USAGE_CONSUMER:
-        return send_consumer_report();
+        return send_report_to_targets(send_consumer_report_to);
     }
 
     LOG_ERR("Unsupported usage page %d", usage_page);
@@ -204,8 +379,8 @@ int zmk_endpoints_send_report(uint16_t usage_page) {
 }
 
 #if IS_ENABLED(CONFIG_ZMK_MOUSE)
-int zmk_endpoints_send_mouse_report() {
-    switch (current_instance.transport) {
+static int send_mouse_report_to_transport(struct zmk_endpoint_instance endpoint) {
+    switch (endpoint.transport) {
     case ZMK_TRANSPORT_USB: {
 #if IS_ENABLED(CONFIG_ZMK_USB)
         int err = zmk_usb_hid_send_mouse_report();
@@ -234,9 +409,22 @@ int zmk_endpoints_send_mouse_report() {
     }
     }
 
-    LOG_ERR("Unhandled endpoint transport %d", current_instance.transport);
+    LOG_ERR("Unhandled endpoint transport %d", endpoint.transport);
     return -ENOTSUP;
 }
+
+static int send_mouse_report_to(struct zmk_endpoint_instance endpoint) {
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_STATS)
+    uint32_t start_cycles = k_cycle_get_32();
+#endif
+    int err = send_mouse_report_to_transport(endpoint);
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_STATS)
+    record_transport_result(endpoint, err, start_cycles);
+#endif
+    return err;
+}
+
+int zmk_endpoints_send_mouse_report() { return send_report_to_targets(send_mouse_report_to); }
 #endif // IS_ENABLED(CONFIG_ZMK_MOUSE)
 
 #if IS_ENABLED(CONFIG_SETTINGS)
@@ -369,6 +557,11 @@ static void update_current_endpoint(void) {
 }
 
 static int endpoint_listener(const zmk_event_t *eh) {
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_SKIP_DUPLICATE_REPORTS)
+    // A (re)connected host has no knowledge of previously sent reports.
+    invalidate_sent_reports();
+#endif
+
     update_current_endpoint();
     return 0;
 }
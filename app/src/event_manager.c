@@ -4,12 +4,27 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <string.h>
+
 #include <zephyr/kernel.h>
+#include <zephyr/init.h>
 #include <zephyr/logging/log.h>
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #include <zmk/event_manager.h>
+#include <zmk/workqueue.h>
+
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_TRACE) && IS_ENABLED(CONFIG_SHELL)
+#include <zephyr/shell/shell.h>
+#endif
+
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_TRACE) && IS_ENABLED(CONFIG_ARCH_POSIX)
+#include <stdlib.h>
+#include <time.h>
+#include <zephyr/init.h>
+#include <zephyr/arch/posix/posix_trace.h>
+#endif
 
 extern struct zmk_event_type *__event_type_start[];
 extern struct zmk_event_type *__event_type_end[];
@@ -17,7 +32,203 @@ extern struct zmk_event_type *__event_type_end[];
 extern struct zmk_event_subscription __event_subscriptions_start[];
 extern struct zmk_event_subscription __event_subscriptions_end[];
 
-int zmk_event_manager_handle_from(zmk_event_t *event, uint8_t start_index) {
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_ASYNC_LISTENERS)
+
+static void zmk_event_manager_async_work_handler(struct k_work *work) {
+    struct zmk_listener_async *async = CONTAINER_OF(work, struct zmk_listener_async, work);
+    uint8_t __aligned(8) buf[ZMK_EVENT_ASYNC_ITEM_SIZE];
+
+    while (k_msgq_get(async->queue, buf, K_NO_WAIT) == 0) {
+        async->callback((const zmk_event_t *)buf);
+    }
+}
+
+static void zmk_event_manager_queue_async(const zmk_event_t *event,
+                                          struct zmk_listener_async *async) {
+    uint8_t __aligned(8) buf[ZMK_EVENT_ASYNC_ITEM_SIZE] = {0};
+
+    if (event->event->size > sizeof(buf)) {
+        LOG_WRN("%s is too large to queue, invoking async listener directly", event->event->name);
+        async->callback(event);
+        return;
+    }
+
+    memcpy(buf, event, event->event->size);
+
+    while (k_msgq_put(async->queue, buf, K_NO_WAIT) != 0) {
+        uint8_t __aligned(8) discarded[ZMK_EVENT_ASYNC_ITEM_SIZE];
+
+        LOG_WRN("Async listener queue full, dropping the oldest event");
+        k_msgq_get(async->queue, discarded, K_NO_WAIT);
+    }
+
+    k_work_submit_to_queue(zmk_workqueue_lowprio_work_q(), &async->work);
+}
+
+static int zmk_event_manager_async_init(void) {
+    for (struct zmk_event_subscription *ev_sub = __event_subscriptions_start;
+         ev_sub < __event_subscriptions_end; ev_sub++) {
+        if (ev_sub->listener->async) {
+            k_work_init(&ev_sub->listener->async->work, zmk_event_manager_async_work_handler);
+        }
+    }
+
+    return 0;
+}
+
+SYS_INIT(zmk_event_manager_async_init, PRE_KERNEL_1, 0);
+
+#endif /* IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_ASYNC_LISTENERS) */
+
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_TRACE)
+
+static struct zmk_event_manager_trace_stats trace_stats;
+
+#if IS_ENABLED(CONFIG_ARCH_POSIX)
+
+// Simulated cycles don't advance while code runs on native_posix, so measure host time instead.
+// The "cycles" recorded are then host nanoseconds.
+static inline uint32_t trace_start(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec);
+}
+
+static inline uint64_t trace_to_us(uint64_t cycles) { return cycles / NSEC_PER_USEC; }
+
+#else
+
+static inline uint32_t trace_start(void) { return k_cycle_get_32(); }
+
+static inline uint64_t trace_to_us(uint64_t cycles) { return k_cyc_to_us_floor64(cycles); }
+
+#endif /* IS_ENABLED(CONFIG_ARCH_POSIX) */
+
+static void trace_record(const struct zmk_event_subscription *ev_sub, uint32_t start, int ret) {
+    struct zmk_event_subscription_stats *stats = ev_sub->stats;
+    uint32_t cycles = trace_start() - start;
+
+    stats->invocations++;
+    stats->total_cycles += cycles;
+    stats->max_cycles = MAX(stats->max_cycles, cycles);
+
+    if (ret == ZMK_EV_EVENT_HANDLED) {
+        stats->handled++;
+    } else if (ret == ZMK_EV_EVENT_CAPTURED) {
+        stats->captured++;
+    }
+}
+
+void zmk_event_manager_trace_get_stats(struct zmk_event_manager_trace_stats *stats) {
+    *stats = trace_stats;
+}
+
+void zmk_event_manager_trace_reset(void) {
+    trace_stats.dispatches = 0;
+    trace_stats.releases = 0;
+    trace_stats.max_depth = trace_stats.depth;
+
+    for (struct zmk_event_subscription *ev_sub = __event_subscriptions_start;
+         ev_sub < __event_subscriptions_end; ev_sub++) {
+        *ev_sub->stats = (struct zmk_event_subscription_stats){0};
+    }
+}
+
+void zmk_event_manager_trace_dump(void) {
+    LOG_INF("Event dispatches: %d, releases: %d, max depth: %d", trace_stats.dispatches,
+            trace_stats.releases, trace_stats.max_depth);
+
+    for (struct zmk_event_subscription *ev_sub = __event_subscriptions_start;
+         ev_sub < __event_subscriptions_end; ev_sub++) {
+        const struct zmk_event_subscription_stats *stats = ev_sub->stats;
+
+        if (stats->invocations == 0) {
+            continue;
+        }
+
+        LOG_INF("%s -> %s: calls %d, handled %d, captured %d, total %lluus, max %lluus",
+                ev_sub->event_type->name, ev_sub->listener->name, stats->invocations,
+                stats->handled, stats->captured, trace_to_us(stats->total_cycles),
+                trace_to_us(stats->max_cycles));
+    }
+}
+
+#if IS_ENABLED(CONFIG_SHELL)
+
+static int cmd_events_stats(const struct shell *sh, size_t argc, char **argv) {
+    shell_print(sh, "dispatches %d, releases %d, max depth %d", trace_stats.dispatches,
+                trace_stats.releases, trace_stats.max_depth);
+    shell_print(sh, "%-32s %-32s %8s %8s %8s %10s %8s", "event", "listener", "calls", "handled",
+                "captured", "total us", "max us");
+
+    for (struct zmk_event_subscription *ev_sub = __event_subscriptions_start;
+         ev_sub < __event_subscriptions_end; ev_sub++) {
+        const struct zmk_event_subscription_stats *stats = ev_sub->stats;
+
+        if (stats->invocations == 0) {
+            continue;
+        }
+
+        shell_print(sh, "%-32s %-32s %8u %8u %8u %10llu %8llu", ev_sub->event_type->name,
+                    ev_sub->listener->name, stats->invocations, stats->handled, stats->captured,
+                    trace_to_us(stats->total_cycles), trace_to_us(stats->max_cycles));
+    }
+
+    return 0;
+}
+
+static int cmd_events_reset(const struct shell *sh, size_t argc, char **argv) {
+    zmk_event_manager_trace_reset();
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_zmk_events,
+                               SHELL_CMD(stats, NULL, "Print event listener statistics",
+                                         cmd_events_stats),
+                               SHELL_CMD(reset, NULL, "Reset event listener statistics",
+                                         cmd_events_reset),
+                               SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(zmk_events, &sub_zmk_events, "ZMK event manager tracing", NULL);
+
+#endif /* IS_ENABLED(CONFIG_SHELL) */
+
+#if IS_ENABLED(CONFIG_ARCH_POSIX)
+
+// Emit one JSON object per line on exit, so test and benchmark runs can be post-processed with
+// e.g. `grep '^zmk_event_trace: ' | cut -d' ' -f2- | jq`.
+static void trace_export(void) {
+    posix_print_trace("zmk_event_trace: {\"dispatches\":%u,\"releases\":%u,\"max_depth\":%u}\n",
+                      trace_stats.dispatches, trace_stats.releases, trace_stats.max_depth);
+
+    for (struct zmk_event_subscription *ev_sub = __event_subscriptions_start;
+         ev_sub < __event_subscriptions_end; ev_sub++) {
+        const struct zmk_event_subscription_stats *stats = ev_sub->stats;
+
+        posix_print_trace("zmk_event_trace: {\"event\":\"%s\",\"listener\":\"%s\",\"calls\":%u,"
+                          "\"handled\":%u,\"captured\":%u,\"total_ns\":%llu,\"max_ns\":%u}\n",
+                          ev_sub->event_type->name, ev_sub->listener->name, stats->invocations,
+                          stats->handled, stats->captured, stats->total_cycles,
+                          stats->max_cycles);
+    }
+}
+
+static int trace_export_init(void) { return atexit(trace_export); }
+
+SYS_INIT(trace_export_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+#endif /* IS_ENABLED(CONFIG_ARCH_POSIX) */
+
+#else
+
+static inline uint32_t trace_start(void) { return 0; }
+static inline void trace_record(const struct zmk_event_subscription *ev_sub, uint32_t start,
+                                int ret) {}
+
+#endif /* IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_TRACE) */
+
+static int zmk_event_manager_dispatch_from(zmk_event_t *event, uint8_t start_index) {
     int ret = 0;
     uint8_t len = __event_subscriptions_end - __event_subscriptions_start;
     for (int i = start_index; i < len; i++) {
@@ -25,8 +236,18 @@ int zmk_event_manager_handle_from(zmk_event_t *event, uint8_t start_index) {
         if (ev_sub->event_type != event->event) {
             continue;
         }
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_ASYNC_LISTENERS)
+        if (ev_sub->listener->async) {
+            uint32_t start = trace_start();
+            zmk_event_manager_queue_async(event, ev_sub->listener->async);
+            trace_record(ev_sub, start, ZMK_EV_EVENT_BUBBLE);
+            continue;
+        }
+#endif
         event->last_listener_index = i;
+        uint32_t start = trace_start();
         ret = ev_sub->listener->callback(event);
+        trace_record(ev_sub, start, ret);
         switch (ret) {
         case ZMK_EV_EVENT_BUBBLE:
             continue;
@@ -45,6 +266,21 @@ int zmk_event_manager_handle_from(zmk_event_t *event, uint8_t start_index) {
     return 0;
 }
 
+int zmk_event_manager_handle_from(zmk_event_t *event, uint8_t start_index) {
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_TRACE)
+    trace_stats.dispatches++;
+    trace_stats.depth++;
+    trace_stats.max_depth = MAX(trace_stats.max_depth, trace_stats.depth);
+
+    int ret = zmk_event_manager_dispatch_from(event, start_index);
+
+    trace_stats.depth--;
+    return ret;
+#else
+    return zmk_event_manager_dispatch_from(event, start_index);
+#endif
+}
+
 int zmk_event_manager_raise(zmk_event_t *event) { return zmk_event_manager_handle_from(event, 0); }
 
 int zmk_event_manager_raise_after(zmk_event_t *event, const struct zmk_listener *listener) {
@@ -78,5 +314,8 @@ int zmk_event_manager_raise_at(zmk_event_t *event, const struct zmk_listener *li
 }
 
 int zmk_event_manager_release(zmk_event_t *event) {
+#if IS_ENABLED(CONFIG_ZMK_EVENT_MANAGER_TRACE)
+    trace_stats.releases++;
+#endif
     return zmk_event_manager_handle_from(event, event->last_listener_index + 1);
 }
@@ -21,7 +21,6 @@ static struct zmk_hid_consumer_report consumer_report = {.report_id = ZMK_HID_RE
 #if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
 
 static zmk_hid_boot_report_t boot_report = {.modifiers = 0, ._reserved = 0, .keys = {0}};
-static uint8_t keys_held = 0;
 
 #endif /* IS_ENABLED(CONFIG_ZMK_USB_BOOT) */
 
@@ -40,6 +39,21 @@ static zmk_mod_flags_t explicit_modifiers = 0;
 static zmk_mod_flags_t implicit_modifiers = 0;
 static zmk_mod_flags_t masked_modifiers = 0;
 
+// The held keys with their implicit modifiers, most recently pressed last. Only the most recently
+// pressed key's implicit modifiers apply, so a key pressed after LS(N1) isn't shifted. Releasing it
+// applies those of the key pressed before it again, so B is shifted again once LC(A) is released
+// while LS(B) is held. Releasing a usage drops every entry for it, since the report holds it only
+// once. If more keys are held, the earliest pressed one is forgotten.
+#define IMPLICIT_MODIFIERS_STACK_SIZE 8
+
+struct implicit_modifiers_entry {
+    uint32_t usage;
+    zmk_mod_flags_t modifiers;
+};
+
+static struct implicit_modifiers_entry implicit_modifiers_stack[IMPLICIT_MODIFIERS_STACK_SIZE];
+static uint8_t implicit_modifiers_depth = 0;
+
 #define SET_MODIFIERS(mods)                                                                        \
     {                                                                                              \
         keyboard_report.body.modifiers = (mods & ~masked_modifiers) | implicit_modifiers;          \
@@ -50,16 +64,13 @@ static zmk_mod_flags_t masked_modifiers = 0;
 
 zmk_mod_flags_t zmk_hid_get_explicit_mods(void) { return explicit_modifiers; }
 
-int zmk_hid_register_mod(zmk_mod_t modifier) {
+static void count_mod_press(zmk_mod_t modifier) {
     explicit_modifier_counts[modifier]++;
     LOG_DBG("Modifier %d count %d", modifier, explicit_modifier_counts[modifier]);
     WRITE_BIT(explicit_modifiers, modifier, true);
-    zmk_mod_flags_t current = GET_MODIFIERS;
-    SET_MODIFIERS(explicit_modifiers);
-    return current == GET_MODIFIERS ? 0 : 1;
 }
 
-int zmk_hid_unregister_mod(zmk_mod_t modifier) {
+static int count_mod_release(zmk_mod_t modifier) {
     if (explicit_modifier_counts[modifier] <= 0) {
         LOG_ERR("Tried to unregister modifier %d too often", modifier);
         return -EINVAL;
@@ -70,6 +81,21 @@ int zmk_hid_unregister_mod(zmk_mod_t modifier) {
         LOG_DBG("Modifier %d released", modifier);
         WRITE_BIT(explicit_modifiers, modifier, false);
     }
+    return 0;
+}
+
+int zmk_hid_register_mod(zmk_mod_t modifier) {
+    count_mod_press(modifier);
+    zmk_mod_flags_t current = GET_MODIFIERS;
+    SET_MODIFIERS(explicit_modifiers);
+    return current == GET_MODIFIERS ? 0 : 1;
+}
+
+int zmk_hid_unregister_mod(zmk_mod_t modifier) {
+    int err = count_mod_release(modifier);
+    if (err < 0) {
+        return err;
+    }
     zmk_mod_flags_t current = GET_MODIFIERS;
     SET_MODIFIERS(explicit_modifiers);
     return current == GET_MODIFIERS ? 0 : 1;
@@ -80,27 +106,69 @@ bool zmk_hid_mod_is_pressed(zmk_mod_t modifier) {
     return (zmk_hid_get_explicit_mods() & mod_flag) == mod_flag;
 }
 
+// Apply all modifier counts first and update the report modifiers once.
 int zmk_hid_register_mods(zmk_mod_flags_t modifiers) {
-    int ret = 0;
+    if (!modifiers) {
+        return 0;
+    }
     for (zmk_mod_t i = 0; i < 8; i++) {
         if (modifiers & (1 << i)) {
-            ret += zmk_hid_register_mod(i);
+            count_mod_press(i);
         }
     }
-    return ret;
+    zmk_mod_flags_t current = GET_MODIFIERS;
+    SET_MODIFIERS(explicit_modifiers);
+    return current == GET_MODIFIERS ? 0 : 1;
 }
 
 int zmk_hid_unregister_mods(zmk_mod_flags_t modifiers) {
-    int ret = 0;
+    if (!modifiers) {
+        return 0;
+    }
     for (zmk_mod_t i = 0; i < 8; i++) {
         if (modifiers & (1 << i)) {
-            ret += zmk_hid_unregister_mod(i);
+            count_mod_release(i);
         }
     }
+    zmk_mod_flags_t current = GET_MODIFIERS;
+    SET_MODIFIERS(explicit_modifiers);
+    return current == GET_MODIFIERS ? 0 : 1;
+}
 
-    return ret;
+#if IS_ENABLED(CONFIG_ZMK_HID_REPORT_TYPE_HKRO) || IS_ENABLED(CONFIG_ZMK_USB_BOOT)
+
+// Small packed lists of held keyboard usages. Entries [0, len) are in use and the rest are zero, so
+// a list can be used directly as a 6KRO style key array. Removing an entry moves the last one into
+// its slot, since hosts treat the key array as an unordered set.
+static int usage_list_index(const uint8_t *list, uint8_t len, zmk_key_t usage) {
+    for (int i = 0; i < len; i++) {
+        if (list[i] == usage) {
+            return i;
+        }
+    }
+    return -1;
 }
 
+static bool usage_list_add(uint8_t *list, uint8_t *len, uint8_t size, zmk_key_t usage) {
+    if (*len >= size) {
+        return false;
+    }
+    list[(*len)++] = usage;
+    return true;
+}
+
+static bool usage_list_remove(uint8_t *list, uint8_t *len, zmk_key_t usage) {
+    int idx = usage_list_index(list, *len, usage);
+    if (idx < 0) {
+        return false;
+    }
+    list[idx] = list[--(*len)];
+    list[*len] = 0;
+    return true;
+}
+
+#endif /* IS_ENABLED(CONFIG_ZMK_HID_REPORT_TYPE_HKRO) || IS_ENABLED(CONFIG_ZMK_USB_BOOT) */
+
 #if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
 
 static zmk_hid_boot_report_t *boot_report_rollover(uint8_t modifiers) {
@@ -117,42 +185,87 @@ static zmk_hid_boot_report_t *boot_report_rollover(uint8_t modifiers) {
 
 #define TOGGLE_KEYBOARD(code, val) WRITE_BIT(keyboard_report.body.keys[code / 8], code % 8, val)
 
-#if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
-zmk_hid_boot_report_t *zmk_hid_get_boot_report(void) {
-    if (keys_held > HID_BOOT_KEY_LEN) {
-        return boot_report_rollover(keyboard_report.body.modifiers);
+static inline bool check_keyboard_usage(zmk_key_t usage) {
+    if (usage > ZMK_HID_KEYBOARD_NKRO_MAX_USAGE) {
+        return false;
     }
+    return keyboard_report.body.keys[usage / 8] & (1 << (usage % 8));
+}
 
-    boot_report.modifiers = keyboard_report.body.modifiers;
+#if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
+
+// Number of distinct keyboard usages held.
+static uint8_t keys_held = 0;
+
+// The boot report key array is kept up to date as usages are selected and deselected, so polling
+// it does not have to scan the NKRO bitmap. Once more keys are held than fit, the boot report is in
+// rollover and the array goes stale; it is rebuilt from the bitmap once the host polls it after
+// enough keys have been released.
+static uint8_t boot_keys_len = 0;
+static bool boot_keys_stale = false;
+
+static void boot_keys_rebuild(void) {
     memset(&boot_report.keys, 0, HID_BOOT_KEY_LEN);
-    int ix = 0;
-    uint8_t base_code = 0;
-    for (int i = 0; i < (ZMK_HID_KEYBOARD_NKRO_MAX_USAGE + 1) / 8; ++i) {
-        if (ix == keys_held) {
-            break;
-        }
-        if (!keyboard_report.body.keys[i]) {
-            continue;
-        }
-        base_code = i * 8;
-        for (int j = 0; j < 8; ++j) {
+    boot_keys_len = 0;
+
+    for (int i = 0; i < sizeof(keyboard_report.body.keys) && boot_keys_len < keys_held; i++) {
+        for (int j = 0; j < 8 && (keyboard_report.body.keys[i] >> j) != 0; j++) {
             if (keyboard_report.body.keys[i] & BIT(j)) {
-                boot_report.keys[ix++] = base_code + j;
+                usage_list_add(boot_report.keys, &boot_keys_len, HID_BOOT_KEY_LEN, i * 8 + j);
             }
         }
     }
+
+    boot_keys_stale = false;
+}
+
+zmk_hid_boot_report_t *zmk_hid_get_boot_report(void) {
+    if (keys_held > HID_BOOT_KEY_LEN) {
+        return boot_report_rollover(keyboard_report.body.modifiers);
+    }
+
+    if (boot_keys_stale) {
+        boot_keys_rebuild();
+    }
+
+    boot_report.modifiers = keyboard_report.body.modifiers;
     return &boot_report;
 }
-#endif
+
+static void boot_keys_select(zmk_key_t usage) {
+    if (++keys_held > HID_BOOT_KEY_LEN) {
+        boot_keys_stale = true;
+    } else if (!boot_keys_stale) {
+        usage_list_add(boot_report.keys, &boot_keys_len, HID_BOOT_KEY_LEN, usage);
+    }
+}
+
+static void boot_keys_deselect(zmk_key_t usage) {
+    --keys_held;
+    if (!boot_keys_stale) {
+        usage_list_remove(boot_report.keys, &boot_keys_len, usage);
+    }
+}
+
+static void boot_keys_clear(void) {
+    keys_held = 0;
+    boot_keys_len = 0;
+    boot_keys_stale = false;
+    memset(&boot_report.keys, 0, HID_BOOT_KEY_LEN);
+}
+
+#endif /* IS_ENABLED(CONFIG_ZMK_USB_BOOT) */
 
 static inline int select_keyboard_usage(zmk_key_t usage) {
     if (usage > ZMK_HID_KEYBOARD_NKRO_MAX_USAGE) {
         return -EINVAL;
     }
-    TOGGLE_KEYBOARD(usage, 1);
 #if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
-    ++keys_held;
+    if (!check_keyboard_usage(usage)) {
+        boot_keys_select(usage);
+    }
 #endif
+    TOGGLE_KEYBOARD(usage, 1);
     return 0;
 }
 
@@ -160,58 +273,59 @@ static inline int deselect_keyboard_usage(zmk_key_t usage) {
     if (usage > ZMK_HID_KEYBOARD_NKRO_MAX_USAGE) {
         return -EINVAL;
     }
-    TOGGLE_KEYBOARD(usage, 0);
 #if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
-    --keys_held;
+    if (check_keyboard_usage(usage)) {
+        boot_keys_deselect(usage);
+    }
 #endif
+    TOGGLE_KEYBOARD(usage, 0);
     return 0;
 }
 
-static inline bool check_keyboard_usage(zmk_key_t usage) {
-    if (usage > ZMK_HID_KEYBOARD_NKRO_MAX_USAGE) {
-        return false;
-    }
-    return keyboard_report.body.keys[usage / 8] & (1 << (usage % 8));
+static inline void clear_keyboard_usages(void) {
+#if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
+    boot_keys_clear();
+#endif
 }
 
 #elif IS_ENABLED(CONFIG_ZMK_HID_REPORT_TYPE_HKRO)
 
-#define TOGGLE_KEYBOARD(match, val)                                                                \
-    for (int idx = 0; idx < CONFIG_ZMK_HID_KEYBOARD_REPORT_SIZE; idx++) {                          \
-        if (keyboard_report.body.keys[idx] != match) {                                             \
-            continue;                                                                              \
-        }                                                                                          \
-        keyboard_report.body.keys[idx] = val;                                                      \
-        if (val) {                                                                                 \
-            break;                                                                                 \
-        }                                                                                          \
+// The report key array is kept packed, so finding a key only looks at the keys actually held and a
+// new key is always appended at the end.
+static uint8_t keyboard_keys_len = 0;
+// Keys pressed while the report was full. They are not reported, but still force boot rollover.
+// They are tracked in a bitmap of the usages the report key array can hold, so pressing one again
+// or releasing a key that never overflowed does not change the count.
+static uint8_t keyboard_keys_overflowed[(UINT8_MAX + 1) / 8];
+static uint8_t keyboard_keys_overflow = 0;
+
+static void keyboard_keys_overflow_write(zmk_key_t usage, bool overflowed) {
+    if (usage > UINT8_MAX ||
+        (bool)(keyboard_keys_overflowed[usage / 8] & BIT(usage % 8)) == overflowed) {
+        return;
     }
 
+    WRITE_BIT(keyboard_keys_overflowed[usage / 8], usage % 8, overflowed);
+    if (overflowed) {
+        keyboard_keys_overflow++;
+    } else {
+        keyboard_keys_overflow--;
+    }
+}
+
 #if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
 zmk_hid_boot_report_t *zmk_hid_get_boot_report(void) {
-    if (keys_held > HID_BOOT_KEY_LEN) {
+    if (keyboard_keys_len + keyboard_keys_overflow > HID_BOOT_KEY_LEN) {
         return boot_report_rollover(keyboard_report.body.modifiers);
     }
 
 #if CONFIG_ZMK_HID_KEYBOARD_REPORT_SIZE != HID_BOOT_KEY_LEN
-    // Form a boot report from a report of different size.
+    // Form a boot report from a report of different size. Since the keys are packed, they are the
+    // start of the report key array.
 
     boot_report.modifiers = keyboard_report.body.modifiers;
-
-    int out = 0;
-    for (int i = 0; i < CONFIG_ZMK_HID_KEYBOARD_REPORT_SIZE; i++) {
-        uint8_t key = keyboard_report.body.keys[i];
-        if (key) {
-            boot_report.keys[out++] = key;
-            if (out == keys_held) {
-                break;
-            }
-        }
-    }
-
-    while (out < HID_BOOT_KEY_LEN) {
-        boot_report.keys[out++] = 0;
-    }
+    memcpy(&boot_report.keys, keyboard_report.body.keys,
+           MIN(HID_BOOT_KEY_LEN, CONFIG_ZMK_HID_KEYBOARD_REPORT_SIZE));
 
     return &boot_report;
 #else
@@ -221,28 +335,29 @@ zmk_hid_boot_report_t *zmk_hid_get_boot_report(void) {
 #endif /* IS_ENABLED(CONFIG_ZMK_USB_BOOT) */
 
 static inline int select_keyboard_usage(zmk_key_t usage) {
-    TOGGLE_KEYBOARD(0U, usage);
-#if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
-    ++keys_held;
-#endif
+    if (usage_list_index(keyboard_report.body.keys, keyboard_keys_len, usage) < 0 &&
+        !usage_list_add(keyboard_report.body.keys, &keyboard_keys_len,
+                        CONFIG_ZMK_HID_KEYBOARD_REPORT_SIZE, usage)) {
+        keyboard_keys_overflow_write(usage, true);
+    }
     return 0;
 }
 
 static inline int deselect_keyboard_usage(zmk_key_t usage) {
-    TOGGLE_KEYBOARD(usage, 0U);
-#if IS_ENABLED(CONFIG_ZMK_USB_BOOT)
-    --keys_held;
-#endif
+    if (!usage_list_remove(keyboard_report.body.keys, &keyboard_keys_len, usage)) {
+        keyboard_keys_overflow_write(usage, false);
+    }
     return 0;
 }
 
 static inline int check_keyboard_usage(zmk_key_t usage) {
-    for (int idx = 0; idx < CONFIG_ZMK_HID_KEYBOARD_REPORT_SIZE; idx++) {
-        if (keyboard_report.body.keys[idx] == usage) {
-            return true;
-        }
-    }
-    return false;
+    return usage_list_index(keyboard_report.body.keys, keyboard_keys_len, usage) >= 0;
+}
+
+static inline void clear_keyboard_usages(void) {
+    keyboard_keys_len = 0;
+    memset(keyboard_keys_overflowed, 0, sizeof(keyboard_keys_overflowed));
+    keyboard_keys_overflow = 0;
 }
 
 #else
@@ -262,15 +377,37 @@ static inline int check_keyboard_usage(zmk_key_t usage) {
         }                                                                                          \
     }
 
-int zmk_hid_implicit_modifiers_press(zmk_mod_flags_t new_implicit_modifiers) {
+static void implicit_modifiers_remove(uint8_t index) {
+    memmove(&implicit_modifiers_stack[index], &implicit_modifiers_stack[index + 1],
+            (implicit_modifiers_depth - index - 1) * sizeof(implicit_modifiers_stack[0]));
+    implicit_modifiers_depth--;
+}
+
+int zmk_hid_implicit_modifiers_press(uint32_t usage, zmk_mod_flags_t new_implicit_modifiers) {
+    if (implicit_modifiers_depth == IMPLICIT_MODIFIERS_STACK_SIZE) {
+        implicit_modifiers_remove(0);
+    }
+    implicit_modifiers_stack[implicit_modifiers_depth++] =
+        (struct implicit_modifiers_entry){.usage = usage, .modifiers = new_implicit_modifiers};
+
     implicit_modifiers = new_implicit_modifiers;
     zmk_mod_flags_t current = GET_MODIFIERS;
     SET_MODIFIERS(explicit_modifiers);
     return current == GET_MODIFIERS ? 0 : 1;
 }
 
-int zmk_hid_implicit_modifiers_release(void) {
-    implicit_modifiers = 0;
+int zmk_hid_implicit_modifiers_release(uint32_t usage) {
+    // A usage pressed again before its release is only in the report once, so releasing it ends
+    // every press of it, whichever key is released first.
+    for (uint8_t i = implicit_modifiers_depth; i > 0; i--) {
+        if (implicit_modifiers_stack[i - 1].usage == usage) {
+            implicit_modifiers_remove(i - 1);
+        }
+    }
+
+    implicit_modifiers = implicit_modifiers_depth > 0
+                             ? implicit_modifiers_stack[implicit_modifiers_depth - 1].modifiers
+                             : 0;
     zmk_mod_flags_t current = GET_MODIFIERS;
     SET_MODIFIERS(explicit_modifiers);
     return current == GET_MODIFIERS ? 0 : 1;
@@ -315,6 +452,7 @@ bool zmk_hid_keyboard_is_pressed(zmk_key_t code) {
 
 void zmk_hid_keyboard_clear(void) {
     memset(&keyboard_report.body, 0, sizeof(keyboard_report.body));
+    clear_keyboard_usages();
 }
 
 int zmk_hid_consumer_press(zmk_key_t code) {
@@ -12,7 +12,11 @@
 #include <zmk/hid_indicators.h>
 #include <zmk/events/hid_indicators_changed.h>
 #include <zmk/events/endpoint_changed.h>
-#include <zmk/split/bluetooth/central.h>
+#include <zmk/workqueue.h>
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+#include <zmk/split/transport/central.h>
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
@@ -32,8 +36,8 @@ static void raise_led_changed_event(struct k_work *_work) {
 
     raise_zmk_hid_indicators_changed((struct zmk_hid_indicators_changed){.indicators = indicators});
 
-#if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS) && IS_ENABLED(CONFIG_ZMK_SPLIT_BLE)
-    zmk_split_bt_update_hid_indicator(indicators);
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+    zmk_split_central_update_hid_indicator(indicators);
 #endif
 }
 
@@ -48,7 +52,7 @@ void zmk_hid_indicators_set_profile(zmk_hid_indicators_t indicators,
     // or writes only one entry at a time, so it is safe to do these operations without a lock.
     hid_indicators[profile] = indicators;
 
-    k_work_submit(&led_changed_work);
+    k_work_submit_to_queue(zmk_workqueue_input_work_q(), &led_changed_work);
 }
 
 void zmk_hid_indicators_process_report(struct zmk_hid_led_report_body *report,
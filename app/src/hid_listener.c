@@ -13,17 +13,139 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/events/keycode_state_changed.h>
 #include <zmk/events/modifiers_state_changed.h>
 #include <zmk/hid.h>
+#include <zmk/hid_listener.h>
 #include <dt-bindings/zmk/hid_usage_pages.h>
 #include <zmk/endpoints.h>
+#include <zmk/workqueue.h>
 
-static int hid_listener_keycode_pressed(const struct zmk_keycode_state_changed *ev) {
-    int err, explicit_mods_changed, implicit_mods_changed;
+#if CONFIG_ZMK_HID_REPRESS_DELAY_MS > 0
 
-    if (!is_mod(ev->usage_page, ev->keycode) &&
-        zmk_hid_is_pressed(ZMK_HID_USAGE(ev->usage_page, ev->keycode))) {
+// Hosts only see the reports they poll, so a usage pressed again right after its release report
+// was sent could look like it was never released. The last released usage is remembered so that
+// pressing it again can wait until the release had time to reach the host.
+static uint32_t released_usage;
+static int64_t released_at;
+
+static void record_release(uint32_t usage) {
+    released_usage = usage;
+    released_at = k_uptime_get();
+}
+
+// Returns how long a press of the usage has to wait for its release to be polled.
+static int64_t repress_wait_ms(uint32_t usage) {
+    if (usage != released_usage) {
+        return 0;
+    }
+
+    return MAX(released_at + CONFIG_ZMK_HID_REPRESS_DELAY_MS + 1 - k_uptime_get(), 0);
+}
+
+#else
+
+static inline void record_release(uint32_t usage) {}
+
+#endif // CONFIG_ZMK_HID_REPRESS_DELAY_MS > 0
+
+// The maximum number of usages changed in one batch before the held back reports are sent.
+#define BATCH_MAX_USAGES 16
+
+static struct {
+    uint8_t depth;
+    bool keyboard_pending;
+    bool consumer_pending;
+    uint8_t usages_len;
+    uint32_t usages[BATCH_MAX_USAGES];
+} batch;
+
+static void batch_send_pending_reports(void) {
+    if (batch.keyboard_pending) {
+        int err = zmk_endpoints_send_report(HID_USAGE_KEY);
+        if (err < 0) {
+            LOG_ERR("Failed to send batched key report (%d)", err);
+        }
+    }
+
+    if (batch.consumer_pending) {
+        int err = zmk_endpoints_send_report(HID_USAGE_CONSUMER);
+        if (err < 0) {
+            LOG_ERR("Failed to send batched consumer report (%d)", err);
+        }
+    }
+
+    batch.keyboard_pending = false;
+    batch.consumer_pending = false;
+    batch.usages_len = 0;
+}
+
+// Called before the usage changes. If it already changed in this batch, the host has to see the
+// reports for that first change before the second one.
+static void batch_track_usage(uint32_t usage) {
+    if (batch.depth == 0) {
+        return;
+    }
+
+    for (int i = 0; i < batch.usages_len; i++) {
+        if (batch.usages[i] == usage) {
+            batch_send_pending_reports();
+            break;
+        }
+    }
+
+    if (batch.usages_len == BATCH_MAX_USAGES) {
+        batch_send_pending_reports();
+    }
+
+    batch.usages[batch.usages_len++] = usage;
+}
+
+void zmk_hid_listener_batch_begin(void) { batch.depth++; }
+
+void zmk_hid_listener_batch_end(void) {
+    if (batch.depth == 0) {
+        LOG_WRN("Ending a HID report batch that was never started");
+        return;
+    }
+
+    if (--batch.depth == 0) {
+        batch_send_pending_reports();
+    }
+}
+
+// Sends the report for the event's usage page. Modifiers are only part of the keyboard report, so
+// for other usage pages it is sent as well if the event changed them. In a batch, the reports are
+// only marked as pending.
+static int hid_listener_send_reports(uint16_t usage_page, zmk_mod_flags_t previous_modifiers) {
+    bool modifiers_changed = zmk_hid_get_keyboard_report()->body.modifiers != previous_modifiers;
+
+    if (batch.depth > 0 && (usage_page == HID_USAGE_KEY || usage_page == HID_USAGE_CONSUMER)) {
+        batch.keyboard_pending |= usage_page == HID_USAGE_KEY || modifiers_changed;
+        batch.consumer_pending |= usage_page == HID_USAGE_CONSUMER;
+        return 0;
+    }
+
+    batch_send_pending_reports();
+
+    if (usage_page != HID_USAGE_KEY && modifiers_changed) {
+        int err = zmk_endpoints_send_report(HID_USAGE_KEY);
+        if (err < 0) {
+            LOG_ERR("Failed to send key report for changed modifiers (%d)", err);
+        }
+    }
+
+    return zmk_endpoints_send_report(usage_page);
+}
+
+// Returns -EAGAIN without pressing the usage if wait is set and the host may not have seen its
+// release yet.
+static int hid_listener_keycode_pressed(const struct zmk_keycode_state_changed *ev, bool wait) {
+    int err;
+    uint32_t usage = ZMK_HID_USAGE(ev->usage_page, ev->keycode);
+
+    if (!is_mod(ev->usage_page, ev->keycode) && zmk_hid_is_pressed(usage)) {
         LOG_DBG("unregistering usage_page 0x%02X keycode 0x%02X since it was already pressed",
                 ev->usage_page, ev->keycode);
-        err = zmk_hid_release(ZMK_HID_USAGE(ev->usage_page, ev->keycode));
+        batch_send_pending_reports();
+        err = zmk_hid_release(usage);
         if (err < 0) {
             LOG_DBG("Unable to pre-release keycode (%d)", err);
             return err;
@@ -32,67 +154,129 @@ static int hid_listener_keycode_pressed(const struct zmk_keycode_state_changed *
         if (err < 0) {
             LOG_ERR("Failed to send key report for pre-releasing keycode (%d)", err);
         }
+        record_release(usage);
+    }
+
+#if CONFIG_ZMK_HID_REPRESS_DELAY_MS > 0
+    if (wait && repress_wait_ms(usage) > 0) {
+        return -EAGAIN;
     }
+#endif
 
     LOG_DBG("usage_page 0x%02X keycode 0x%02X implicit_mods 0x%02X explicit_mods 0x%02X",
             ev->usage_page, ev->keycode, ev->implicit_modifiers, ev->explicit_modifiers);
-    err = zmk_hid_press(ZMK_HID_USAGE(ev->usage_page, ev->keycode));
+    batch_track_usage(usage);
+    zmk_mod_flags_t previous_modifiers = zmk_hid_get_keyboard_report()->body.modifiers;
+    err = zmk_hid_press(usage);
     if (err < 0) {
         LOG_DBG("Unable to press keycode");
         return err;
     }
-    explicit_mods_changed = zmk_hid_register_mods(ev->explicit_modifiers);
-    implicit_mods_changed = zmk_hid_implicit_modifiers_press(ev->implicit_modifiers);
-    if (ev->usage_page != HID_USAGE_KEY &&
-        (explicit_mods_changed > 0 || implicit_mods_changed > 0)) {
-        err = zmk_endpoints_send_report(HID_USAGE_KEY);
-        if (err < 0) {
-            LOG_ERR("Failed to send key report for changed mofifiers for consumer page event (%d)",
-                    err);
-        }
-    }
+    zmk_hid_register_mods(ev->explicit_modifiers);
+    zmk_hid_implicit_modifiers_press(usage, ev->implicit_modifiers);
 
-    return zmk_endpoints_send_report(ev->usage_page);
+    return hid_listener_send_reports(ev->usage_page, previous_modifiers);
 }
 
 static int hid_listener_keycode_released(const struct zmk_keycode_state_changed *ev) {
-    int err, explicit_mods_changed, implicit_mods_changed;
+    int err;
 
     LOG_DBG("usage_page 0x%02X keycode 0x%02X implicit_mods 0x%02X explicit_mods 0x%02X",
             ev->usage_page, ev->keycode, ev->implicit_modifiers, ev->explicit_modifiers);
-    err = zmk_hid_release(ZMK_HID_USAGE(ev->usage_page, ev->keycode));
+    zmk_mod_flags_t previous_modifiers = zmk_hid_get_keyboard_report()->body.modifiers;
+    uint32_t usage = ZMK_HID_USAGE(ev->usage_page, ev->keycode);
+    batch_track_usage(usage);
+    err = zmk_hid_release(usage);
     if (err < 0) {
         LOG_DBG("Unable to release keycode");
         return err;
     }
+    zmk_hid_unregister_mods(ev->explicit_modifiers);
+    zmk_hid_implicit_modifiers_release(usage);
 
-    explicit_mods_changed = zmk_hid_unregister_mods(ev->explicit_modifiers);
-    // There is a minor issue with this code.
-    // If LC(A) is pressed, then LS(B), then LC(A) is released, the shift for B will be released
-    // prematurely. This causes if LS(B) to repeat like Bbbbbbbb when pressed for a long time.
-    // Solving this would require keeping track of which key's implicit modifiers are currently
-    // active and only releasing modifiers at that time.
-    implicit_mods_changed = zmk_hid_implicit_modifiers_release();
-    ;
-    if (ev->usage_page != HID_USAGE_KEY &&
-        (explicit_mods_changed > 0 || implicit_mods_changed > 0)) {
-        err = zmk_endpoints_send_report(HID_USAGE_KEY);
-        if (err < 0) {
-            LOG_ERR("Failed to send key report for changed mofifiers for consumer page event (%d)",
-                    err);
+    err = hid_listener_send_reports(ev->usage_page, previous_modifiers);
+    if (!is_mod(ev->usage_page, ev->keycode)) {
+        record_release(usage);
+    }
+
+    return err;
+}
+
+static int hid_listener_keycode_changed(const struct zmk_keycode_state_changed *ev, bool wait) {
+    return ev->state ? hid_listener_keycode_pressed(ev, wait) : hid_listener_keycode_released(ev);
+}
+
+#if CONFIG_ZMK_HID_REPRESS_DELAY_MS > 0
+
+// Keycode events that arrive while a press waits for its usage's release to be polled are held
+// back as well, so the host still sees all of them in order.
+K_MSGQ_DEFINE(deferred_keycode_events, sizeof(struct zmk_keycode_state_changed_event),
+              CONFIG_ZMK_HID_REPRESS_QUEUE_SIZE, 8);
+
+static void deferred_keycode_work_callback(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(deferred_keycode_work, deferred_keycode_work_callback);
+
+static void schedule_deferred_keycode_work(const struct zmk_keycode_state_changed *ev) {
+    uint32_t usage = ZMK_HID_USAGE(ev->usage_page, ev->keycode);
+
+    k_work_reschedule_for_queue(zmk_workqueue_input_work_q(), &deferred_keycode_work,
+                                K_MSEC(repress_wait_ms(usage)));
+}
+
+// Handles the held back events in order, then lets the remaining listeners see each of them. If
+// wait is not set, presses are sent without waiting for the host to poll the releases.
+static void process_deferred_keycode_events(bool wait) {
+    struct zmk_keycode_state_changed_event ev;
+
+    while (k_msgq_peek(&deferred_keycode_events, &ev) == 0) {
+        if (hid_listener_keycode_changed(&ev.data, wait) == -EAGAIN) {
+            schedule_deferred_keycode_work(&ev.data);
+            return;
         }
+
+        k_msgq_get(&deferred_keycode_events, &ev, K_NO_WAIT);
+        ZMK_EVENT_RELEASE(ev);
     }
-    return zmk_endpoints_send_report(ev->usage_page);
 }
 
+static void deferred_keycode_work_callback(struct k_work *work) {
+    process_deferred_keycode_events(true);
+}
+
+static int defer_keycode_event(const struct zmk_keycode_state_changed *ev) {
+    struct zmk_keycode_state_changed_event copy = copy_raised_zmk_keycode_state_changed(ev);
+
+    if (k_msgq_put(&deferred_keycode_events, &copy, K_NO_WAIT) != 0) {
+        LOG_WRN("Deferred keycode event queue full, sending held back presses now");
+        k_work_cancel_delayable(&deferred_keycode_work);
+        process_deferred_keycode_events(false);
+        hid_listener_keycode_changed(ev, false);
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    LOG_DBG("Holding back %s of usage_page 0x%02X keycode 0x%02X",
+            ev->state ? "press" : "release", ev->usage_page, ev->keycode);
+    if (k_msgq_num_used_get(&deferred_keycode_events) == 1) {
+        schedule_deferred_keycode_work(ev);
+    }
+
+    return ZMK_EV_EVENT_CAPTURED;
+}
+
+#endif // CONFIG_ZMK_HID_REPRESS_DELAY_MS > 0
+
 int hid_listener(const zmk_event_t *eh) {
     const struct zmk_keycode_state_changed *ev = as_zmk_keycode_state_changed(eh);
     if (ev) {
-        if (ev->state) {
-            hid_listener_keycode_pressed(ev);
-        } else {
-            hid_listener_keycode_released(ev);
+#if CONFIG_ZMK_HID_REPRESS_DELAY_MS > 0
+        if (k_msgq_num_used_get(&deferred_keycode_events) > 0 ||
+            hid_listener_keycode_changed(ev, true) == -EAGAIN) {
+            return defer_keycode_event(ev);
         }
+#else
+        hid_listener_keycode_changed(ev, false);
+#endif
     }
     return 0;
 }
@@ -15,6 +15,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zephyr/bluetooth/gatt.h>
 
 #include <zmk/ble.h>
+#include <zmk/endpoints.h>
 #include <zmk/endpoints_types.h>
 #include <zmk/hog.h>
 #include <zmk/hid.h>
@@ -239,22 +240,67 @@ K_THREAD_STACK_DEFINE(hog_q_stack, CONFIG_ZMK_BLE_THREAD_STACK_SIZE);
 
 struct k_work_q hog_work_q;
 
-K_MSGQ_DEFINE(zmk_hog_keyboard_msgq, sizeof(struct zmk_hid_keyboard_report_body),
+// In mirror mode, never wait for queue space so the USB reports sent next aren't delayed.
+#define REPORT_QUEUE_TIMEOUT                                                                       \
+    COND_CODE_1(IS_ENABLED(CONFIG_ZMK_ENDPOINTS_MIRROR), (K_NO_WAIT), (K_MSEC(100)))
+
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_STATS) ||                                                      \
+    IS_ENABLED(CONFIG_ZMK_ENDPOINTS_SKIP_DUPLICATE_REPORTS)
+static struct zmk_endpoint_instance active_endpoint(void) {
+    return (struct zmk_endpoint_instance){
+        .transport = ZMK_TRANSPORT_BLE,
+        .ble = {.profile_index = zmk_ble_active_profile_index()},
+    };
+}
+#endif
+
+// A report that never reaches the host must not be treated as sent, or the next identical report
+// would be skipped.
+static void invalidate_sent_report(uint16_t usage_page) {
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_SKIP_DUPLICATE_REPORTS)
+    zmk_endpoints_invalidate_sent_report(active_endpoint(), usage_page);
+#endif
+}
+
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_STATS)
+
+static void record_notify_result(int err, uint32_t queued_cycles) {
+    if (err) {
+        zmk_endpoints_record_dropped(active_endpoint());
+    } else {
+        zmk_endpoints_record_sent(active_endpoint(),
+                                  k_cyc_to_us_floor32(k_cycle_get_32() - queued_cycles));
+    }
+}
+#endif // IS_ENABLED(CONFIG_ZMK_ENDPOINTS_STATS)
+
+struct hog_keyboard_msg {
+    struct zmk_hid_keyboard_report_body report;
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_STATS)
+    uint32_t queued_cycles;
+#endif
+};
+
+K_MSGQ_DEFINE(zmk_hog_keyboard_msgq, sizeof(struct hog_keyboard_msg),
               CONFIG_ZMK_BLE_KEYBOARD_REPORT_QUEUE_SIZE, 4);
 
 void send_keyboard_report_callback(struct k_work *work) {
-    struct zmk_hid_keyboard_report_body report;
+    struct hog_keyboard_msg msg;
 
-    while (k_msgq_get(&zmk_hog_keyboard_msgq, &report, K_NO_WAIT) == 0) {
+    while (k_msgq_get(&zmk_hog_keyboard_msgq, &msg, K_NO_WAIT) == 0) {
         struct bt_conn *conn = destination_connection();
         if (conn == NULL) {
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_STATS)
+            record_notify_result(-ENOTCONN, msg.queued_cycles);
+#endif
+            invalidate_sent_report(HID_USAGE_KEY);
             return;
         }
 
         struct bt_gatt_notify_params notify_params = {
             .attr = &hog_svc.attrs[5],
-            .data = &report,
-            .len = sizeof(report),
+            .data = &msg.report,
+            .len = sizeof(msg.report),
         };
 
         int err = bt_gatt_notify_cb(conn, &notify_params);
@@ -263,6 +309,12 @@ void send_keyboard_report_callback(struct k_work *work) {
         } else if (err) {
             LOG_DBG("Error notifying %d", err);
         }
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_STATS)
+        record_notify_result(err, msg.queued_cycles);
+#endif
+        if (err) {
+            invalidate_sent_report(HID_USAGE_KEY);
+        }
 
         bt_conn_unref(conn);
     }
@@ -271,13 +323,23 @@ void send_keyboard_report_callback(struct k_work *work) {
 K_WORK_DEFINE(hog_keyboard_work, send_keyboard_report_callback);
 
 int zmk_hog_send_keyboard_report(struct zmk_hid_keyboard_report_body *report) {
-    int err = k_msgq_put(&zmk_hog_keyboard_msgq, report, K_MSEC(100));
+    struct hog_keyboard_msg msg = {
+        .report = *report,
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_STATS)
+        .queued_cycles = k_cycle_get_32(),
+#endif
+    };
+    int err = k_msgq_put(&zmk_hog_keyboard_msgq, &msg, REPORT_QUEUE_TIMEOUT);
     if (err) {
         switch (err) {
+        case -ENOMSG:
         case -EAGAIN: {
             LOG_WRN("Keyboard message queue full, popping first message and queueing again");
-            struct zmk_hid_keyboard_report_body discarded_report;
-            k_msgq_get(&zmk_hog_keyboard_msgq, &discarded_report, K_NO_WAIT);
+            struct hog_keyboard_msg discarded;
+            k_msgq_get(&zmk_hog_keyboard_msgq, &discarded, K_NO_WAIT);
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_STATS)
+            zmk_endpoints_record_dropped(active_endpoint());
+#endif
             return zmk_hog_send_keyboard_report(report);
         }
         default:
@@ -291,22 +353,33 @@ int zmk_hog_send_keyboard_report(struct zmk_hid_keyboard_report_body *report) {
     return 0;
 };
 
-K_MSGQ_DEFINE(zmk_hog_consumer_msgq, sizeof(struct zmk_hid_consumer_report_body),
+struct hog_consumer_msg {
+    struct zmk_hid_consumer_report_body report;
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_STATS)
+    uint32_t queued_cycles;
+#endif
+};
+
+K_MSGQ_DEFINE(zmk_hog_consumer_msgq, sizeof(struct hog_consumer_msg),
               CONFIG_ZMK_BLE_CONSUMER_REPORT_QUEUE_SIZE, 4);
 
 void send_consumer_report_callback(struct k_work *work) {
-    struct zmk_hid_consumer_report_body report;
+    struct hog_consumer_msg msg;
 
-    while (k_msgq_get(&zmk_hog_consumer_msgq, &report, K_NO_WAIT) == 0) {
+    while (k_msgq_get(&zmk_hog_consumer_msgq, &msg, K_NO_WAIT) == 0) {
         struct bt_conn *conn = destination_connection();
         if (conn == NULL) {
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_STATS)
+            record_notify_result(-ENOTCONN, msg.queued_cycles);
+#endif
+            invalidate_sent_report(HID_USAGE_CONSUMER);
             return;
         }
 
         struct bt_gatt_notify_params notify_params = {
             .attr = &hog_svc.attrs[9],
-            .data = &report,
-            .len = sizeof(report),
+            .data = &msg.report,
+            .len = sizeof(msg.report),
         };
 
         int err = bt_gatt_notify_cb(conn, &notify_params);
@@ -315,6 +388,12 @@ void send_consumer_report_callback(struct k_work *work) {
         } else if (err) {
             LOG_DBG("Error notifying %d", err);
         }
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_STATS)
+        record_notify_result(err, msg.queued_cycles);
+#endif
+        if (err) {
+            invalidate_sent_report(HID_USAGE_CONSUMER);
+        }
 
         bt_conn_unref(conn);
     }
@@ -323,13 +402,23 @@ void send_consumer_report_callback(struct k_work *work) {
 K_WORK_DEFINE(hog_consumer_work, send_consumer_report_callback);
 
 int zmk_hog_send_consumer_report(struct zmk_hid_consumer_report_body *report) {
-    int err = k_msgq_put(&zmk_hog_consumer_msgq, report, K_MSEC(100));
+    struct hog_consumer_msg msg = {
+        .report = *report,
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_STATS)
+        .queued_cycles = k_cycle_get_32(),
+#endif
+    };
+    int err = k_msgq_put(&zmk_hog_consumer_msgq, &msg, REPORT_QUEUE_TIMEOUT);
     if (err) {
         switch (err) {
+        case -ENOMSG:
         case -EAGAIN: {
             LOG_WRN("Consumer message queue full, popping first message and queueing again");
-            struct zmk_hid_consumer_report_body discarded_report;
-            k_msgq_get(&zmk_hog_consumer_msgq, &discarded_report, K_NO_WAIT);
+            struct hog_consumer_msg discarded;
+            k_msgq_get(&zmk_hog_consumer_msgq, &discarded, K_NO_WAIT);
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_STATS)
+            zmk_endpoints_record_dropped(active_endpoint());
+#endif
             return zmk_hog_send_consumer_report(report);
         }
         default:
@@ -345,21 +434,31 @@ int zmk_hog_send_consumer_report(struct zmk_hid_consumer_report_body *report) {
 
 #if IS_ENABLED(CONFIG_ZMK_MOUSE)
 
-K_MSGQ_DEFINE(zmk_hog_mouse_msgq, sizeof(struct zmk_hid_mouse_report_body),
+struct hog_mouse_msg {
+    struct zmk_hid_mouse_report_body report;
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_STATS)
+    uint32_t queued_cycles;
+#endif
+};
+
+K_MSGQ_DEFINE(zmk_hog_mouse_msgq, sizeof(struct hog_mouse_msg),
               CONFIG_ZMK_BLE_MOUSE_REPORT_QUEUE_SIZE, 4);
 
 void send_mouse_report_callback(struct k_work *work) {
-    struct zmk_hid_mouse_report_body report;
-    while (k_msgq_get(&zmk_hog_mouse_msgq, &report, K_NO_WAIT) == 0) {
+    struct hog_mouse_msg msg;
+    while (k_msgq_get(&zmk_hog_mouse_msgq, &msg, K_NO_WAIT) == 0) {
         struct bt_conn *conn = destination_connection();
         if (conn == NULL) {
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_STATS)
+            record_notify_result(-ENOTCONN, msg.queued_cycles);
+#endif
             return;
         }
 
         struct bt_gatt_notify_params notify_params = {
             .attr = &hog_svc.attrs[13],
-            .data = &report,
-            .len = sizeof(report),
+            .data = &msg.report,
+            .len = sizeof(msg.report),
         };
 
         int err = bt_gatt_notify_cb(conn, &notify_params);
@@ -368,6 +467,9 @@ void send_mouse_report_callback(struct k_work *work) {
         } else if (err) {
             LOG_DBG("Error notifying %d", err);
         }
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_STATS)
+        record_notify_result(err, msg.queued_cycles);
+#endif
 
         bt_conn_unref(conn);
     }
@@ -376,13 +478,23 @@ void send_mouse_report_callback(struct k_work *work) {
 K_WORK_DEFINE(hog_mouse_work, send_mouse_report_callback);
 
 int zmk_hog_send_mouse_report(struct zmk_hid_mouse_report_body *report) {
-    int err = k_msgq_put(&zmk_hog_mouse_msgq, report, K_MSEC(100));
+    struct hog_mouse_msg msg = {
+        .report = *report,
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_STATS)
+        .queued_cycles = k_cycle_get_32(),
+#endif
+    };
+    int err = k_msgq_put(&zmk_hog_mouse_msgq, &msg, REPORT_QUEUE_TIMEOUT);
     if (err) {
         switch (err) {
+        case -ENOMSG:
         case -EAGAIN: {
             LOG_WRN("Consumer message queue full, popping first message and queueing again");
-            struct zmk_hid_mouse_report_body discarded_report;
-            k_msgq_get(&zmk_hog_mouse_msgq, &discarded_report, K_NO_WAIT);
+            struct hog_mouse_msg discarded;
+            k_msgq_get(&zmk_hog_mouse_msgq, &discarded, K_NO_WAIT);
+#if IS_ENABLED(CONFIG_ZMK_ENDPOINTS_STATS)
+            zmk_endpoints_record_dropped(active_endpoint());
+#endif
             return zmk_hog_send_mouse_report(report);
         }
         default:
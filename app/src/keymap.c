@@ -12,13 +12,13 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #include <zmk/behavior.h>
 #include <zmk/keymap.h>
+#include <zmk/conditional_layer.h>
 #include <zmk/matrix.h>
 #include <zmk/sensors.h>
 #include <zmk/virtual_key_position.h>
 
-#include <zmk/ble.h>
-#if ZMK_BLE_IS_CENTRAL
-#include <zmk/split/bluetooth/central.h>
+#if IS_ENABLED(CONFIG_ZMK_SPLIT) && IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+#include <zmk/split/transport/central.h>
 #endif
 
 #include <zmk/event_manager.h>
@@ -26,8 +26,13 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/events/layer_state_changed.h>
 #include <zmk/events/sensor_event.h>
 
-static zmk_keymap_layers_state_t _zmk_keymap_layer_state = 0;
+static zmk_keymap_layers_state_t _zmk_keymap_layer_state;
+
+// Layers are addressed with a uint8_t throughout the keymap API.
+BUILD_ASSERT(ZMK_KEYMAP_LAYERS_LEN <= UINT8_MAX, "Keymaps are limited to 255 layers");
 static uint8_t _zmk_keymap_layer_default = 0;
+// Highest active layer for _zmk_keymap_layer_state, kept up to date whenever the state changes.
+static uint8_t _zmk_keymap_highest_layer = 0;
 
 #define DT_DRV_COMPAT zmk_keymap
 
@@ -59,7 +64,7 @@ static uint8_t _zmk_keymap_layer_default = 0;
 // When a behavior handles a key position "down" event, we record the layer state
 // here so that even if that layer is deactivated before the "up", event, we
 // still send the release event to the behavior in that layer also.
-static uint32_t zmk_keymap_active_behavior_layer[ZMK_KEYMAP_LEN];
+static zmk_keymap_layers_state_t zmk_keymap_active_behavior_layer[ZMK_KEYMAP_LEN];
 
 static struct zmk_behavior_binding zmk_keymap[ZMK_KEYMAP_LAYERS_LEN][ZMK_KEYMAP_LEN] = {
     DT_INST_FOREACH_CHILD_SEP(0, TRANSFORMED_LAYER, (, ))};
@@ -75,23 +80,43 @@ static struct zmk_behavior_binding
 
 #endif /* ZMK_KEYMAP_HAS_SENSORS */
 
-static inline int set_layer_state(uint8_t layer, bool state) {
+// Every layer that exists in the keymap.
+static const zmk_keymap_layers_state_t all_layers_state =
+    ZMK_KEYMAP_LAYERS_STATE_INIT(ZMK_KEYMAP_LAYERS_STATE_ALL_WORD);
+
+// Applies all changes in one step, so a single layer_state_changed event is raised no matter how
+// many layer bits (including conditional then-layers) change. `layer` is the layer the action
+// targeted and is reported in the event for listeners that only care about one layer.
+static int set_layers_state(zmk_keymap_layers_state_t mask, zmk_keymap_layers_state_t value,
+                            uint8_t layer) {
     int ret = 0;
-    if (layer >= ZMK_KEYMAP_LAYERS_LEN) {
+    if (layer >= ZMK_KEYMAP_LAYERS_LEN ||
+        !zmk_keymap_layers_state_empty(zmk_keymap_layers_state_and_not(mask, all_layers_state))) {
         return -EINVAL;
     }
 
     // Default layer should *always* remain active
-    if (layer == _zmk_keymap_layer_default && !state) {
-        return 0;
+    if (!zmk_keymap_layers_state_test(value, _zmk_keymap_layer_default)) {
+        mask = zmk_keymap_layers_state_write(mask, _zmk_keymap_layer_default, false);
     }
 
     zmk_keymap_layers_state_t old_state = _zmk_keymap_layer_state;
-    WRITE_BIT(_zmk_keymap_layer_state, layer, state);
+    zmk_keymap_layers_state_t new_state = zmk_keymap_layers_state_or(
+        zmk_keymap_layers_state_and_not(old_state, mask), zmk_keymap_layers_state_and(value, mask));
+
+    // Resolve conditional layers before publishing, so one action raises one event no matter how
+    // many then-layers it toggles.
+    _zmk_keymap_layer_state = zmk_conditional_layer_apply(new_state, _zmk_keymap_layer_default);
+
+    // The default layer is always active, so it is the floor for the highest active layer.
+    _zmk_keymap_highest_layer =
+        MAX(zmk_keymap_layers_state_highest(_zmk_keymap_layer_state), _zmk_keymap_layer_default);
+
     // Don't send state changes unless there was an actual change
-    if (old_state != _zmk_keymap_layer_state) {
+    if (!zmk_keymap_layers_state_equal(old_state, _zmk_keymap_layer_state)) {
+        bool state = zmk_keymap_layer_active(layer);
         LOG_DBG("layer_changed: layer %d state %d", layer, state);
-        ret = raise_layer_state_changed(layer, state);
+        ret = raise_layer_state_changed(layer, state, old_state, _zmk_keymap_layer_state);
         if (ret < 0) {
             LOG_WRN("Failed to raise layer state changed (%d)", ret);
         }
@@ -100,6 +125,17 @@ static inline int set_layer_state(uint8_t layer, bool state) {
     return ret;
 }
 
+static inline int set_layer_state(uint8_t layer, bool state) {
+    if (layer >= ZMK_KEYMAP_LAYERS_LEN) {
+        return -EINVAL;
+    }
+
+    zmk_keymap_layers_state_t mask = zmk_keymap_layers_state_bit(layer);
+    zmk_keymap_layers_state_t value = {0};
+
+    return set_layers_state(mask, state ? mask : value, layer);
+}
+
 uint8_t zmk_keymap_layer_default(void) { return _zmk_keymap_layer_default; }
 
 zmk_keymap_layers_state_t zmk_keymap_layer_state(void) { return _zmk_keymap_layer_state; }
@@ -107,46 +143,38 @@ zmk_keymap_layers_state_t zmk_keymap_layer_state(void) { return _zmk_keymap_laye
 bool zmk_keymap_layer_active_with_state(uint8_t layer, zmk_keymap_layers_state_t state_to_test) {
     // The default layer is assumed to be ALWAYS ACTIVE so we include an || here to ensure nobody
     // breaks up that assumption by accident
-    return (state_to_test & (BIT(layer))) == (BIT(layer)) || layer == _zmk_keymap_layer_default;
+    return zmk_keymap_layers_state_test(state_to_test, layer) || layer == _zmk_keymap_layer_default;
 };
 
 bool zmk_keymap_layer_active(uint8_t layer) {
     return zmk_keymap_layer_active_with_state(layer, _zmk_keymap_layer_state);
 };
 
-uint8_t zmk_keymap_highest_layer_active(void) {
-    for (uint8_t layer = ZMK_KEYMAP_LAYERS_LEN - 1; layer > 0; layer--) {
-        if (zmk_keymap_layer_active(layer)) {
-            return layer;
-        }
-    }
-    return zmk_keymap_layer_default();
-}
+uint8_t zmk_keymap_highest_layer_active(void) { return _zmk_keymap_highest_layer; }
 
 int zmk_keymap_layer_activate(uint8_t layer) { return set_layer_state(layer, true); };
 
 int zmk_keymap_layer_deactivate(uint8_t layer) { return set_layer_state(layer, false); };
 
 int zmk_keymap_layer_toggle(uint8_t layer) {
-    if (zmk_keymap_layer_active(layer)) {
-        return zmk_keymap_layer_deactivate(layer);
-    }
-
-    return zmk_keymap_layer_activate(layer);
+    return set_layer_state(layer, !zmk_keymap_layer_active(layer));
 };
 
 int zmk_keymap_layer_to(uint8_t layer) {
-    for (int i = ZMK_KEYMAP_LAYERS_LEN - 1; i >= 0; i--) {
-        zmk_keymap_layer_deactivate(i);
+    if (layer >= ZMK_KEYMAP_LAYERS_LEN) {
+        return -EINVAL;
     }
 
-    zmk_keymap_layer_activate(layer);
+    return set_layers_state(all_layers_state, zmk_keymap_layers_state_bit(layer), layer);
+}
 
-    return 0;
+int zmk_keymap_layers_update(zmk_keymap_layers_state_t mask, zmk_keymap_layers_state_t value,
+                             uint8_t layer) {
+    return set_layers_state(mask, value, layer);
 }
 
 bool is_active_layer(uint8_t layer, zmk_keymap_layers_state_t layer_state) {
-    return (layer_state & BIT(layer)) == BIT(layer) || layer == _zmk_keymap_layer_default;
+    return zmk_keymap_layers_state_test(layer_state, layer) || layer == _zmk_keymap_layer_default;
 }
 
 const char *zmk_keymap_layer_name(uint8_t layer) {
@@ -207,19 +235,19 @@ int zmk_run_behavior(struct zmk_behavior_binding *binding, struct zmk_behavior_b
     case BEHAVIOR_LOCALITY_CENTRAL:
         return invoke_locally(binding, event, pressed);
     case BEHAVIOR_LOCALITY_EVENT_SOURCE:
-#if ZMK_BLE_IS_CENTRAL
+#if IS_ENABLED(CONFIG_ZMK_SPLIT) && IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
         if (source == ZMK_POSITION_STATE_CHANGE_SOURCE_LOCAL) {
             return invoke_locally(binding, event, pressed);
         } else {
-            return zmk_split_bt_invoke_behavior(source, &binding, event, pressed);
+            return zmk_split_central_invoke_behavior(source, binding, event, pressed);
         }
 #else
         return invoke_locally(binding, event, pressed);
 #endif
     case BEHAVIOR_LOCALITY_GLOBAL:
-#if ZMK_BLE_IS_CENTRAL
-        for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
-            zmk_split_bt_invoke_behavior(i, binding, event, pressed);
+#if IS_ENABLED(CONFIG_ZMK_SPLIT) && IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+        for (int i = 0; i < zmk_split_central_peripheral_count(); i++) {
+            zmk_split_central_invoke_behavior(i, binding, event, pressed);
         }
 #endif
         return invoke_locally(binding, event, pressed);
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdlib.h>
+#include <time.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/arch/posix/posix_trace.h>
+
+#include <zmk/keymap.h>
+#include <zmk/keymap_benchmark.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/layer_state_changed.h>
+#include <zmk/events/position_state_changed.h>
+
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_BENCHMARK_REPLAY)
+#include <zmk/kscan.h>
+#endif
+
+// Keeps the compiler from discarding the calls being measured.
+static volatile uint32_t benchmark_sink;
+
+static uint32_t layer_state_changes;
+
+static int keymap_benchmark_listener(const zmk_event_t *eh) {
+    layer_state_changes++;
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(keymap_benchmark, keymap_benchmark_listener);
+ZMK_SUBSCRIPTION(keymap_benchmark, zmk_layer_state_changed);
+
+// Simulated time does not advance while code runs on native_posix, so measure host time instead.
+static uint64_t benchmark_now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+// `ops` counts the operations that had the expected effect, so the test snapshot can check it.
+static void benchmark_report(const char *name, uint64_t start_ns, uint32_t ops) {
+    uint64_t total_ns = benchmark_now_ns() - start_ns;
+
+    posix_print_trace("zmk_keymap_benchmark: {\"name\":\"%s\",\"ops\":%u,\"iterations\":%u,"
+                      "\"total_ns\":%llu,\"ns_per_op\":%llu}\n",
+                      name, ops, CONFIG_ZMK_KEYMAP_BENCHMARK_ITERATIONS, total_ns,
+                      total_ns / MAX(ops, 1));
+}
+
+static void benchmark_highest_layer_active(uint8_t expected) {
+    uint32_t ops = 0;
+    uint64_t start = benchmark_now_ns();
+
+    for (int i = 0; i < CONFIG_ZMK_KEYMAP_BENCHMARK_ITERATIONS; i++) {
+        uint8_t layer = zmk_keymap_highest_layer_active();
+
+        benchmark_sink += layer;
+        ops += layer == expected;
+    }
+
+    benchmark_report("highest_layer_active", start, ops);
+}
+
+// Each activation and deactivation changes the layer state, so each raises one event.
+static void benchmark_layer_toggle(uint8_t layer) {
+    uint64_t start = benchmark_now_ns();
+
+    layer_state_changes = 0;
+    for (int i = 0; i < CONFIG_ZMK_KEYMAP_BENCHMARK_ITERATIONS; i++) {
+        zmk_keymap_layer_activate(layer);
+        zmk_keymap_layer_deactivate(layer);
+    }
+
+    benchmark_report("layer_activate_deactivate", start, layer_state_changes);
+}
+
+static void benchmark_position_dispatch(const char *name) {
+    uint32_t ops = 0;
+    uint64_t start = benchmark_now_ns();
+
+    for (int i = 0; i < CONFIG_ZMK_KEYMAP_BENCHMARK_ITERATIONS; i++) {
+        int pressed = zmk_keymap_position_state_changed(
+            ZMK_POSITION_STATE_CHANGE_SOURCE_LOCAL, CONFIG_ZMK_KEYMAP_BENCHMARK_POSITION, true, i);
+        int released = zmk_keymap_position_state_changed(
+            ZMK_POSITION_STATE_CHANGE_SOURCE_LOCAL, CONFIG_ZMK_KEYMAP_BENCHMARK_POSITION, false, i);
+
+        ops += (pressed >= 0) + (released >= 0);
+    }
+
+    benchmark_report(name, start, ops);
+}
+
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_BENCHMARK_REPLAY)
+
+static uint64_t replay_start_ns;
+
+// Runs when kscan_mock exits after its last event.
+static void benchmark_replay_report(void) {
+    uint64_t total_ns = MAX(benchmark_now_ns() - replay_start_ns, 1);
+    struct zmk_kscan_latency_stats kscan_stats;
+    struct zmk_event_manager_trace_stats trace_stats;
+
+    zmk_kscan_get_latency_stats(&kscan_stats);
+    zmk_event_manager_trace_get_stats(&trace_stats);
+
+    uint32_t events = kscan_stats.count;
+
+    posix_print_trace("zmk_keymap_benchmark: {\"name\":\"replay\",\"events\":%u,\"total_ns\":%llu,"
+                      "\"ns_per_event\":%llu,\"events_per_sec\":%llu,\"kscan_max_queue_depth\":%u,"
+                      "\"kscan_dropped\":%u,\"dispatches\":%u,\"releases\":%u,\"max_depth\":%u}\n",
+                      events, total_ns, total_ns / MAX(events, 1),
+                      (uint64_t)events * NSEC_PER_SEC / total_ns, kscan_stats.max_queue_depth,
+                      kscan_stats.dropped, trace_stats.dispatches, trace_stats.releases,
+                      trace_stats.max_depth);
+}
+
+// Times everything from here to exit. Statistics are reset so they only cover the replay, and
+// the event manager trace printed on exit breaks the cost down per listener.
+static void benchmark_replay_start(void) {
+    zmk_event_manager_trace_reset();
+    zmk_kscan_reset_latency_stats();
+    atexit(benchmark_replay_report);
+
+    replay_start_ns = benchmark_now_ns();
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_KEYMAP_BENCHMARK_REPLAY)
+
+void zmk_keymap_benchmark_run(void) {
+    uint8_t top_layer = ZMK_KEYMAP_LAYERS_LEN - 1;
+    zmk_keymap_layers_state_t initial_state = zmk_keymap_layer_state();
+
+    benchmark_highest_layer_active(zmk_keymap_layer_default());
+    benchmark_layer_toggle(top_layer);
+    benchmark_position_dispatch("position_dispatch_default_layer");
+
+    // With the top layer active, dispatch has to fall through every layer in between.
+    zmk_keymap_layer_activate(top_layer);
+    benchmark_highest_layer_active(top_layer);
+    benchmark_position_dispatch("position_dispatch_top_layer");
+    zmk_keymap_layer_deactivate(top_layer);
+
+    posix_print_trace("zmk_keymap_benchmark: {\"name\":\"final_state\",\"highest_layer\":%d,"
+                      "\"layer_state_restored\":%s}\n",
+                      zmk_keymap_highest_layer_active(),
+                      zmk_keymap_layers_state_equal(zmk_keymap_layer_state(), initial_state)
+                          ? "true"
+                          : "false");
+
+#if IS_ENABLED(CONFIG_ZMK_KEYMAP_BENCHMARK_REPLAY)
+    benchmark_replay_start();
+#endif
+}
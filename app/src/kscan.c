@@ -12,10 +12,19 @@
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
+#include <zmk/kscan.h>
 #include <zmk/matrix_transform.h>
 #include <zmk/event_manager.h>
+#include <zmk/workqueue.h>
 #include <zmk/events/position_state_changed.h>
 
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_TRACE_RECORD)
+#include <stdio.h>
+
+#include "soc.h"
+#include "cmdline.h"
+#endif
+
 #define ZMK_KSCAN_EVENT_STATE_PRESSED 0
 #define ZMK_KSCAN_EVENT_STATE_RELEASED 1
 
@@ -23,6 +32,11 @@ struct zmk_kscan_event {
     uint32_t row;
     uint32_t column;
     uint32_t state;
+    // Uptime when the driver reported the event, so queueing delay doesn't shift key timing.
+    int64_t timestamp;
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_LATENCY_STATS)
+    uint32_t cycles;
+#endif
 };
 
 struct zmk_kscan_msg_processor {
@@ -31,21 +45,119 @@ struct zmk_kscan_msg_processor {
 
 K_MSGQ_DEFINE(zmk_kscan_msgq, sizeof(struct zmk_kscan_event), CONFIG_ZMK_KSCAN_EVENT_QUEUE_SIZE, 4);
 
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_LATENCY_STATS)
+
+static struct zmk_kscan_latency_stats latency_stats = {.min_us = UINT32_MAX};
+
+static void zmk_kscan_record_queued(int err) {
+    if (err) {
+        latency_stats.dropped++;
+        return;
+    }
+
+    latency_stats.max_queue_depth =
+        MAX(latency_stats.max_queue_depth, k_msgq_num_used_get(&zmk_kscan_msgq));
+}
+
+#endif /* IS_ENABLED(CONFIG_ZMK_KSCAN_LATENCY_STATS) */
+
 static void zmk_kscan_callback(const struct device *dev, uint32_t row, uint32_t column,
                                bool pressed) {
     struct zmk_kscan_event ev = {
         .row = row,
         .column = column,
-        .state = (pressed ? ZMK_KSCAN_EVENT_STATE_PRESSED : ZMK_KSCAN_EVENT_STATE_RELEASED)};
+        .state = (pressed ? ZMK_KSCAN_EVENT_STATE_PRESSED : ZMK_KSCAN_EVENT_STATE_RELEASED),
+        .timestamp = k_uptime_get(),
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_LATENCY_STATS)
+        .cycles = k_cycle_get_32(),
+#endif
+    };
+
+    int err = k_msgq_put(&zmk_kscan_msgq, &ev, K_NO_WAIT);
+    if (err) {
+        LOG_WRN("KSCAN event queue full, dropping event");
+    }
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_LATENCY_STATS)
+    zmk_kscan_record_queued(err);
+#endif
+    k_work_submit_to_queue(zmk_workqueue_input_work_q(), &msg_processor.work);
+}
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_LATENCY_STATS)
+
+static void zmk_kscan_record_latency(uint32_t start_cycles) {
+    uint32_t us = k_cyc_to_us_floor32(k_cycle_get_32() - start_cycles);
 
-    k_msgq_put(&zmk_kscan_msgq, &ev, K_NO_WAIT);
-    k_work_submit(&msg_processor.work);
+    latency_stats.count++;
+    latency_stats.total_us += us;
+    latency_stats.min_us = MIN(latency_stats.min_us, us);
+    latency_stats.max_us = MAX(latency_stats.max_us, us);
+
+    if ((latency_stats.count % 100) == 0) {
+        LOG_DBG("Scan latency over %d events: min %dus, max %dus, avg %dus", latency_stats.count,
+                latency_stats.min_us, latency_stats.max_us,
+                (uint32_t)(latency_stats.total_us / latency_stats.count));
+    }
 }
 
+void zmk_kscan_get_latency_stats(struct zmk_kscan_latency_stats *stats) { *stats = latency_stats; }
+
+void zmk_kscan_reset_latency_stats(void) {
+    latency_stats = (struct zmk_kscan_latency_stats){.min_us = UINT32_MAX};
+}
+
+#endif /* IS_ENABLED(CONFIG_ZMK_KSCAN_LATENCY_STATS) */
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_TRACE_RECORD)
+
+static char *record_path;
+static FILE *record_file;
+
+static void zmk_kscan_record_options(void) {
+    static struct args_struct_t options[] = {
+        {.option = "kscan-record",
+         .name = "path",
+         .type = 's',
+         .dest = (void *)&record_path,
+         .descript = "Record kscan events to a trace file that kscan_mock can replay"},
+        ARG_TABLE_ENDMARKER};
+
+    native_add_command_line_opts(options);
+}
+
+NATIVE_TASK(zmk_kscan_record_options, PRE_BOOT_1, 10);
+
+static void zmk_kscan_record_open(void) {
+    if (record_path == NULL) {
+        return;
+    }
+
+    record_file = fopen(record_path, "w");
+    if (record_file == NULL) {
+        LOG_ERR("Failed to open kscan trace %s for recording", record_path);
+    }
+}
+
+// Writes one line in the format kscan_mock replays: "<uptime ms> <p|r> <row> <column>". The uptime
+// is when the driver reported the event, so a busy input work queue doesn't shift the replay.
+static void zmk_kscan_record(const struct zmk_kscan_event *ev) {
+    if (record_file == NULL) {
+        return;
+    }
+
+    fprintf(record_file, "%lld %c %u %u\n", (long long)ev->timestamp,
+            ev->state == ZMK_KSCAN_EVENT_STATE_PRESSED ? 'p' : 'r', ev->row, ev->column);
+}
+
+#endif /* IS_ENABLED(CONFIG_ZMK_KSCAN_TRACE_RECORD) */
+
 void zmk_kscan_process_msgq(struct k_work *item) {
     struct zmk_kscan_event ev;
 
     while (k_msgq_get(&zmk_kscan_msgq, &ev, K_NO_WAIT) == 0) {
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_TRACE_RECORD)
+        zmk_kscan_record(&ev);
+#endif
         bool pressed = (ev.state == ZMK_KSCAN_EVENT_STATE_PRESSED);
         int32_t position = zmk_matrix_transform_row_column_to_position(ev.row, ev.column);
 
@@ -61,7 +173,11 @@ void zmk_kscan_process_msgq(struct k_work *item) {
             (struct zmk_position_state_changed){.source = ZMK_POSITION_STATE_CHANGE_SOURCE_LOCAL,
                                                 .state = pressed,
                                                 .position = position,
-                                                .timestamp = k_uptime_get()});
+                                                .timestamp = ev.timestamp});
+
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_LATENCY_STATS)
+        zmk_kscan_record_latency(ev.cycles);
+#endif
     }
 }
 
@@ -73,6 +189,10 @@ int zmk_kscan_init(const struct device *dev) {
 
     k_work_init(&msg_processor.work, zmk_kscan_process_msgq);
 
+#if IS_ENABLED(CONFIG_ZMK_KSCAN_TRACE_RECORD)
+    zmk_kscan_record_open();
+#endif
+
     kscan_config(dev, zmk_kscan_callback);
     kscan_enable_callback(dev);
 
@@ -21,9 +21,17 @@ LOG_MODULE_REGISTER(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/mouse.h>
 #endif /* CONFIG_ZMK_MOUSE */
 
+#ifdef CONFIG_ZMK_KEYMAP_BENCHMARK
+#include <zmk/keymap_benchmark.h>
+#endif /* CONFIG_ZMK_KEYMAP_BENCHMARK */
+
 int main(void) {
     LOG_INF("Welcome to ZMK!\n");
 
+#ifdef CONFIG_ZMK_KEYMAP_BENCHMARK
+    zmk_keymap_benchmark_run();
+#endif /* CONFIG_ZMK_KEYMAP_BENCHMARK */
+
     if (zmk_kscan_init(DEVICE_DT_GET(ZMK_MATRIX_NODE_ID)) != 0) {
         return -ENOTSUP;
     }
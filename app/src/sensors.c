@@ -15,6 +15,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/sensors.h>
 #include <zmk/event_manager.h>
 #include <zmk/events/sensor_event.h>
+#include <zmk/workqueue.h>
 
 #if ZMK_KEYMAP_HAS_SENSORS
 
@@ -69,6 +70,64 @@ const struct zmk_sensor_config *zmk_sensors_get_config_at_index(uint8_t sensor_i
     return &configs[sensor_index];
 }
 
+#if CONFIG_ZMK_KEYMAP_SENSORS_BATCH_MS > 0
+
+struct sensors_batch {
+    struct sensor_value value;
+    int64_t timestamp;
+    bool pending;
+};
+
+static struct sensors_batch batches[ZMK_KEYMAP_SENSORS_LEN];
+static struct k_spinlock batches_lock;
+
+static void flush_sensor_batches(struct k_work *work) {
+    for (int i = 0; i < ARRAY_SIZE(batches); i++) {
+        k_spinlock_key_t key = k_spin_lock(&batches_lock);
+        struct sensors_batch batch = batches[i];
+        batches[i] = (struct sensors_batch){0};
+        k_spin_unlock(&batches_lock, key);
+
+        if (!batch.pending || (batch.value.val1 == 0 && batch.value.val2 == 0)) {
+            continue;
+        }
+
+        struct zmk_sensor_channel_data channel_data = {.value = batch.value,
+                                                       .channel = sensors[i].trigger.chan};
+
+        raise_zmk_sensor_event((struct zmk_sensor_event){.sensor_index = sensors[i].sensor_index,
+                                                         .channel_data_size = 1,
+                                                         .channel_data = {channel_data},
+                                                         .timestamp = batch.timestamp});
+    }
+}
+
+K_WORK_DELAYABLE_DEFINE(sensor_batch_work, flush_sensor_batches);
+
+static void batch_sensor_value(uint32_t sensor_index, struct sensor_value value) {
+    k_spinlock_key_t key = k_spin_lock(&batches_lock);
+    struct sensors_batch *batch = &batches[sensor_index];
+
+    if (!batch->pending) {
+        batch->pending = true;
+        batch->timestamp = k_uptime_get();
+    }
+
+    batch->value.val1 += value.val1;
+    batch->value.val2 += value.val2;
+    batch->value.val1 += batch->value.val2 / 1000000;
+    batch->value.val2 %= 1000000;
+
+    k_spin_unlock(&batches_lock, key);
+
+    // Does not push back an already scheduled flush, so the window is bounded from the first
+    // trigger no matter how fast the sensor keeps firing.
+    k_work_schedule_for_queue(zmk_workqueue_input_work_q(), &sensor_batch_work,
+                              K_MSEC(CONFIG_ZMK_KEYMAP_SENSORS_BATCH_MS));
+}
+
+#endif /* CONFIG_ZMK_KEYMAP_SENSORS_BATCH_MS > 0 */
+
 static void trigger_sensor_data_for_position(uint32_t sensor_index) {
     int err;
     const struct sensors_item_cfg *item = &sensors[sensor_index];
@@ -87,12 +146,16 @@ static void trigger_sensor_data_for_position(uint32_t sensor_index) {
         return;
     }
 
+#if CONFIG_ZMK_KEYMAP_SENSORS_BATCH_MS > 0
+    batch_sensor_value(sensor_index, value);
+#else
     raise_zmk_sensor_event(
         (struct zmk_sensor_event){.sensor_index = item->sensor_index,
                                   .channel_data_size = 1,
                                   .channel_data = {(struct zmk_sensor_channel_data){
                                       .value = value, .channel = item->trigger.chan}},
                                   .timestamp = k_uptime_get()});
+#endif
 }
 
 static void run_sensors_data_trigger(struct k_work *work) {
@@ -118,7 +181,7 @@ static void zmk_sensors_trigger_handler(const struct device *dev,
 
     if (k_is_in_isr()) {
         atomic_set_bit(pending_sensors, sensor_index);
-        k_work_submit(&sensor_data_work);
+        k_work_submit_to_queue(zmk_workqueue_input_work_q(), &sensor_data_work);
     } else {
         trigger_sensor_data_for_position(sensor_index);
     }
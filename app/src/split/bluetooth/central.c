@@ -18,22 +18,31 @@
 
 LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
+#include <drivers/behavior.h>
 #include <zmk/stdlib.h>
 #include <zmk/ble.h>
 #include <zmk/behavior.h>
 #include <zmk/sensors.h>
 #include <zmk/split/bluetooth/uuid.h>
 #include <zmk/split/bluetooth/service.h>
+#include <zmk/split/bluetooth/central.h>
+#include <zmk/split/transport/central.h>
 #include <zmk/event_manager.h>
 #include <zmk/events/position_state_changed.h>
 #include <zmk/events/sensor_event.h>
 #include <zmk/events/battery_state_changed.h>
 #include <zmk/hid_indicators_types.h>
+#include <zmk/workqueue.h>
 
 static int start_scanning(void);
 
 #define POSITION_STATE_DATA_LEN 16
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_BEHAVIOR_IDS)
+#define BEHAVIOR_NAME_BUF_LEN 32
+#define BEHAVIOR_ID_BATCH_MAX 8
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_BEHAVIOR_IDS)
+
 enum peripheral_slot_state {
     PERIPHERAL_SLOT_STATE_OPEN,
     PERIPHERAL_SLOT_STATE_CONNECTING,
@@ -55,6 +64,17 @@ struct peripheral_slot {
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
     uint16_t update_hid_indicators;
 #endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_BEHAVIOR_IDS)
+    uint16_t behavior_names_handle;
+    uint16_t run_behavior_by_id_handle;
+    struct bt_gatt_read_params behavior_names_read_params;
+    // Peripheral behavior ID of each central behavior, indexed like the zmk_behavior_ref section.
+    uint8_t behavior_ids[CONFIG_ZMK_SPLIT_BLE_CENTRAL_BEHAVIOR_ID_TABLE_SIZE];
+    bool behavior_ids_ready;
+    uint8_t next_behavior_id;
+    char behavior_name[BEHAVIOR_NAME_BUF_LEN];
+    uint8_t behavior_name_len;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_BEHAVIOR_IDS)
     uint8_t position_state[POSITION_STATE_DATA_LEN];
     uint8_t changed_positions[POSITION_STATE_DATA_LEN];
 };
@@ -65,6 +85,8 @@ static bool is_scanning = false;
 
 static const struct bt_uuid_128 split_service_uuid = BT_UUID_INIT_128(ZMK_SPLIT_BT_SERVICE_UUID);
 
+#if !IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN)
+
 K_MSGQ_DEFINE(peripheral_event_msgq, sizeof(struct zmk_position_state_changed),
               CONFIG_ZMK_SPLIT_BLE_CENTRAL_POSITION_QUEUE_SIZE, 4);
 
@@ -78,6 +100,8 @@ void peripheral_event_work_callback(struct k_work *work) {
 
 K_WORK_DEFINE(peripheral_event_work, peripheral_event_work_callback);
 
+#endif // !IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN)
+
 int peripheral_slot_index_for_conn(struct bt_conn *conn) {
     for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
         if (peripherals[i].conn == conn) {
@@ -117,6 +141,11 @@ int release_peripheral_slot(int index) {
     slot->state = PERIPHERAL_SLOT_STATE_OPEN;
 
     // Raise events releasing any active positions from this peripheral
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN)
+    // Releases that do not fit in the fan-in queue stay pending and clear their bits once raised.
+    const uint8_t released_state[ZMK_SPLIT_POSITION_STATE_LEN] = {0};
+    zmk_split_central_position_state_received(index, released_state, slot->position_state);
+#else
     for (int i = 0; i < POSITION_STATE_DATA_LEN; i++) {
         for (int j = 0; j < 8; j++) {
             if (slot->position_state[i] & BIT(j)) {
@@ -127,13 +156,17 @@ int release_peripheral_slot(int index) {
                                                         .timestamp = k_uptime_get()};
 
                 k_msgq_put(&peripheral_event_msgq, &ev, K_NO_WAIT);
-                k_work_submit(&peripheral_event_work);
+                k_work_submit_to_queue(zmk_workqueue_input_work_q(), &peripheral_event_work);
             }
         }
     }
 
     for (int i = 0; i < POSITION_STATE_DATA_LEN; i++) {
         slot->position_state[i] = 0U;
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN)
+
+    for (int i = 0; i < POSITION_STATE_DATA_LEN; i++) {
         slot->changed_positions[i] = 0U;
     }
 
@@ -143,6 +176,11 @@ int release_peripheral_slot(int index) {
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
     slot->update_hid_indicators = 0;
 #endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_BEHAVIOR_IDS)
+    slot->behavior_names_handle = 0;
+    slot->run_behavior_by_id_handle = 0;
+    slot->behavior_ids_ready = false;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_BEHAVIOR_IDS)
 
     return 0;
 }
@@ -219,8 +257,12 @@ static uint8_t split_central_sensor_notify_func(struct bt_conn *conn,
 
     memcpy(ev.channel_data, sensor_event.channel_data,
            sizeof(struct zmk_sensor_channel_data) * sensor_event.channel_data_size);
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN)
+    zmk_split_central_fan_in_sensor_event(peripheral_slot_index_for_conn(conn), ev);
+#else
     k_msgq_put(&peripheral_sensor_event_msgq, &ev, K_NO_WAIT);
-    k_work_submit(&peripheral_sensor_event_work);
+    k_work_submit_to_queue(zmk_workqueue_input_work_q(), &peripheral_sensor_event_work);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN)
 
     return BT_GATT_ITER_CONTINUE;
 }
@@ -244,6 +286,12 @@ static uint8_t split_central_notify_func(struct bt_conn *conn,
 
     LOG_DBG("[NOTIFICATION] data %p length %u", data, length);
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN)
+    uint8_t state[ZMK_SPLIT_POSITION_STATE_LEN] = {0};
+    memcpy(state, data, MIN(length, sizeof(state)));
+    zmk_split_central_position_state_received(peripheral_slot_index_for_conn(conn), state,
+                                              slot->position_state);
+#else
     for (int i = 0; i < POSITION_STATE_DATA_LEN; i++) {
         slot->changed_positions[i] = ((uint8_t *)data)[i] ^ slot->position_state[i];
         slot->position_state[i] = ((uint8_t *)data)[i];
@@ -262,10 +310,11 @@ static uint8_t split_central_notify_func(struct bt_conn *conn,
                                                         .timestamp = k_uptime_get()};
 
                 k_msgq_put(&peripheral_event_msgq, &ev, K_NO_WAIT);
-                k_work_submit(&peripheral_event_work);
+                k_work_submit_to_queue(zmk_workqueue_input_work_q(), &peripheral_event_work);
             }
         }
     }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN)
 
     return BT_GATT_ITER_CONTINUE;
 }
@@ -287,6 +336,8 @@ int zmk_split_get_peripheral_battery_level(uint8_t source, uint8_t *level) {
     return 0;
 }
 
+#if !IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN)
+
 K_MSGQ_DEFINE(peripheral_batt_lvl_msgq, sizeof(struct zmk_peripheral_battery_state_changed),
               CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_QUEUE_SIZE, 4);
 
@@ -301,6 +352,18 @@ void peripheral_batt_lvl_change_callback(struct k_work *work) {
 
 K_WORK_DEFINE(peripheral_batt_lvl_work, peripheral_batt_lvl_change_callback);
 
+#endif // !IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN)
+
+static void queue_peripheral_battery_state_changed(struct zmk_peripheral_battery_state_changed ev) {
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN)
+    peripheral_battery_levels[ev.source] = ev.state_of_charge;
+    zmk_split_central_fan_in_peripheral_battery_state_changed(ev);
+#else
+    k_msgq_put(&peripheral_batt_lvl_msgq, &ev, K_NO_WAIT);
+    k_work_submit_to_queue(zmk_workqueue_input_work_q(), &peripheral_batt_lvl_work);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN)
+}
+
 static uint8_t split_central_battery_level_notify_func(struct bt_conn *conn,
                                                        struct bt_gatt_subscribe_params *params,
                                                        const void *data, uint16_t length) {
@@ -327,8 +390,7 @@ static uint8_t split_central_battery_level_notify_func(struct bt_conn *conn,
     LOG_DBG("Battery level: %u", battery_level);
     struct zmk_peripheral_battery_state_changed ev = {
         .source = peripheral_slot_index_for_conn(conn), .state_of_charge = battery_level};
-    k_msgq_put(&peripheral_batt_lvl_msgq, &ev, K_NO_WAIT);
-    k_work_submit(&peripheral_batt_lvl_work);
+    queue_peripheral_battery_state_changed(ev);
 
     return BT_GATT_ITER_CONTINUE;
 }
@@ -366,14 +428,100 @@ static uint8_t split_central_battery_level_read_func(struct bt_conn *conn, uint8
 
     struct zmk_peripheral_battery_state_changed ev = {
         .source = peripheral_slot_index_for_conn(conn), .state_of_charge = battery_level};
-    k_msgq_put(&peripheral_batt_lvl_msgq, &ev, K_NO_WAIT);
-    k_work_submit(&peripheral_batt_lvl_work);
+    queue_peripheral_battery_state_changed(ev);
 
     return BT_GATT_ITER_CONTINUE;
 }
 
 #endif /* IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING) */
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_BEHAVIOR_IDS)
+static int local_behavior_index(const char *name) {
+    ptrdiff_t count;
+    STRUCT_SECTION_COUNT(zmk_behavior_ref, &count);
+    count = MIN(count, CONFIG_ZMK_SPLIT_BLE_CENTRAL_BEHAVIOR_ID_TABLE_SIZE);
+
+    for (ptrdiff_t i = 0; i < count; i++) {
+        const struct zmk_behavior_ref *ref;
+        STRUCT_SECTION_GET(zmk_behavior_ref, i, &ref);
+
+        if (ref->device->name == name || strcmp(ref->device->name, name) == 0) {
+            return i;
+        }
+    }
+
+    return -ENODEV;
+}
+
+static void add_peripheral_behavior_name(struct peripheral_slot *slot, char c) {
+    if (c != '\0') {
+        // Overlong names are left unmatched rather than matched by a truncated prefix.
+        if (slot->behavior_name_len < sizeof(slot->behavior_name)) {
+            slot->behavior_name[slot->behavior_name_len++] = c;
+        }
+        return;
+    }
+
+    if (slot->behavior_name_len < sizeof(slot->behavior_name)) {
+        slot->behavior_name[slot->behavior_name_len] = '\0';
+
+        int index = local_behavior_index(slot->behavior_name);
+        if (index >= 0) {
+            LOG_DBG("Peripheral behavior %s has ID %d", slot->behavior_name,
+                    slot->next_behavior_id);
+            slot->behavior_ids[index] = slot->next_behavior_id;
+        }
+    }
+
+    slot->next_behavior_id++;
+    slot->behavior_name_len = 0;
+}
+
+static uint8_t split_central_behavior_names_read_func(struct bt_conn *conn, uint8_t err,
+                                                      struct bt_gatt_read_params *params,
+                                                      const void *data, uint16_t length) {
+    struct peripheral_slot *slot = peripheral_slot_for_conn(conn);
+    if (slot == NULL) {
+        LOG_ERR("No peripheral state found for connection");
+        return BT_GATT_ITER_STOP;
+    }
+
+    if (err) {
+        LOG_ERR("Failed to read peripheral behavior names (err %d)", err);
+        return BT_GATT_ITER_STOP;
+    }
+
+    if (data == NULL) {
+        LOG_DBG("Read %d peripheral behavior names", slot->next_behavior_id);
+        slot->behavior_ids_ready = true;
+        return BT_GATT_ITER_STOP;
+    }
+
+    for (uint16_t i = 0; i < length; i++) {
+        add_peripheral_behavior_name(slot, ((const char *)data)[i]);
+    }
+
+    return BT_GATT_ITER_CONTINUE;
+}
+
+static void split_central_read_behavior_names(struct bt_conn *conn, struct peripheral_slot *slot) {
+    memset(slot->behavior_ids, ZMK_SPLIT_BEHAVIOR_ID_UNKNOWN, sizeof(slot->behavior_ids));
+    slot->behavior_ids_ready = false;
+    slot->next_behavior_id = 0;
+    slot->behavior_name_len = 0;
+
+    slot->behavior_names_read_params.func = split_central_behavior_names_read_func;
+    slot->behavior_names_read_params.handle_count = 1;
+    slot->behavior_names_read_params.single.handle = slot->behavior_names_handle;
+    slot->behavior_names_read_params.single.offset = 0;
+
+    int err = bt_gatt_read(conn, &slot->behavior_names_read_params);
+    if (err) {
+        LOG_ERR("Failed to start reading peripheral behavior names (err %d)", err);
+    }
+}
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_BEHAVIOR_IDS)
+
 static int split_central_subscribe(struct bt_conn *conn, struct bt_gatt_subscribe_params *params) {
     int err = bt_gatt_subscribe(conn, params);
     switch (err) {
@@ -447,6 +595,17 @@ static uint8_t split_central_chrc_discovery_func(struct bt_conn *conn,
         LOG_DBG("Found update HID indicators handle");
         slot->update_hid_indicators = bt_gatt_attr_value_handle(attr);
 #endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_BEHAVIOR_IDS)
+    } else if (!bt_uuid_cmp(chrc_uuid,
+                            BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_BEHAVIOR_NAMES_UUID))) {
+        LOG_DBG("Found behavior names handle");
+        slot->behavior_names_handle = bt_gatt_attr_value_handle(attr);
+        split_central_read_behavior_names(conn, slot);
+    } else if (!bt_uuid_cmp(chrc_uuid,
+                            BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_RUN_BEHAVIOR_BY_ID_UUID))) {
+        LOG_DBG("Found run behavior by ID handle");
+        slot->run_behavior_by_id_handle = bt_gatt_attr_value_handle(attr);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_BEHAVIOR_IDS)
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING)
     } else if (!bt_uuid_cmp(((struct bt_gatt_chrc *)attr->user_data)->uuid,
                             BT_UUID_BAS_BATTERY_LEVEL)) {
@@ -478,6 +637,10 @@ static uint8_t split_central_chrc_discovery_func(struct bt_conn *conn,
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING)
     subscribed = subscribed && slot->batt_lvl_subscribe_params.value_handle;
 #endif /* IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING) */
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_BEHAVIOR_IDS)
+    // Peripherals without behavior IDs simply run discovery to completion.
+    subscribed = subscribed && slot->behavior_names_handle && slot->run_behavior_by_id_handle;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_BEHAVIOR_IDS)
 
     return subscribed ? BT_GATT_ITER_STOP : BT_GATT_ITER_CONTINUE;
 }
@@ -586,9 +749,13 @@ static bool split_central_eir_found(const bt_addr_le_t *addr) {
     }
 
     LOG_DBG("Initiating new connnection");
-    struct bt_le_conn_param *param =
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_CONN_GOVERNOR)
+    const struct bt_le_conn_param *param = zmk_split_bt_central_conn_governor_param();
+#else
+    const struct bt_le_conn_param *param =
         BT_LE_CONN_PARAM(CONFIG_ZMK_SPLIT_BLE_PREF_INT, CONFIG_ZMK_SPLIT_BLE_PREF_INT,
                          CONFIG_ZMK_SPLIT_BLE_PREF_LATENCY, CONFIG_ZMK_SPLIT_BLE_PREF_TIMEOUT);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_CONN_GOVERNOR)
     err = bt_conn_le_create(addr, BT_CONN_LE_CREATE_CONN, param, &slot->conn);
     if (err < 0) {
         LOG_ERR("Create conn failed (err %d) (create conn? 0x%04x)", err, BT_HCI_OP_LE_CREATE_CONN);
@@ -725,8 +892,7 @@ static void split_central_disconnected(struct bt_conn *conn, uint8_t reason) {
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING)
     struct zmk_peripheral_battery_state_changed ev = {
         .source = peripheral_slot_index_for_conn(conn), .state_of_charge = 0};
-    k_msgq_put(&peripheral_batt_lvl_msgq, &ev, K_NO_WAIT);
-    k_work_submit(&peripheral_batt_lvl_work);
+    queue_peripheral_battery_state_changed(ev);
 #endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_BATTERY_LEVEL_FETCHING)
 
     err = release_peripheral_slot_for_conn(conn);
@@ -750,6 +916,9 @@ struct k_work_q split_central_split_run_q;
 
 struct zmk_split_run_behavior_payload_wrapper {
     uint8_t source;
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_BEHAVIOR_IDS)
+    int behavior_index;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_BEHAVIOR_IDS)
     struct zmk_split_run_behavior_payload payload;
 };
 
@@ -757,6 +926,67 @@ K_MSGQ_DEFINE(zmk_split_central_split_run_msgq,
               sizeof(struct zmk_split_run_behavior_payload_wrapper),
               CONFIG_ZMK_SPLIT_BLE_CENTRAL_SPLIT_RUN_QUEUE_SIZE, 4);
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_BEHAVIOR_IDS)
+struct behavior_id_batch {
+    struct zmk_split_run_behavior_id_payload payloads[BEHAVIOR_ID_BATCH_MAX];
+    uint8_t len;
+};
+
+// Only accessed from the split run work item.
+static struct behavior_id_batch behavior_id_batches[ZMK_SPLIT_BLE_PERIPHERAL_COUNT];
+
+static void flush_behavior_id_batch(uint8_t source) {
+    struct behavior_id_batch *batch = &behavior_id_batches[source];
+    if (batch->len == 0) {
+        return;
+    }
+
+    if (peripherals[source].state == PERIPHERAL_SLOT_STATE_CONNECTED &&
+        peripherals[source].run_behavior_by_id_handle) {
+        int err = bt_gatt_write_without_response(
+            peripherals[source].conn, peripherals[source].run_behavior_by_id_handle,
+            batch->payloads, batch->len * sizeof(batch->payloads[0]), true);
+        if (err) {
+            LOG_ERR("Failed to write the behavior by ID characteristic (err %d)", err);
+        }
+    }
+
+    batch->len = 0;
+}
+
+/**
+ * Adds the invocation to the pending write for its peripheral if the behavior has a peripheral ID.
+ * The write is sent once as many invocations as fit in the ATT MTU have been added.
+ *
+ * @returns true if the invocation was added, false if it needs to be sent by name.
+ */
+static bool batch_behavior_by_id(const struct zmk_split_run_behavior_payload_wrapper *wrapper) {
+    struct peripheral_slot *slot = &peripherals[wrapper->source];
+    if (!slot->behavior_ids_ready || !slot->run_behavior_by_id_handle ||
+        wrapper->behavior_index < 0) {
+        return false;
+    }
+
+    uint8_t id = slot->behavior_ids[wrapper->behavior_index];
+    if (id == ZMK_SPLIT_BEHAVIOR_ID_UNKNOWN) {
+        return false;
+    }
+
+    struct behavior_id_batch *batch = &behavior_id_batches[wrapper->source];
+    batch->payloads[batch->len++] = (struct zmk_split_run_behavior_id_payload){
+        .behavior_id = id,
+        .data = wrapper->payload.data,
+    };
+
+    size_t capacity = (bt_gatt_get_mtu(slot->conn) - 3) / sizeof(batch->payloads[0]);
+    if (batch->len >= CLAMP(capacity, 1, BEHAVIOR_ID_BATCH_MAX)) {
+        flush_behavior_id_batch(wrapper->source);
+    }
+
+    return true;
+}
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_BEHAVIOR_IDS)
+
 void split_central_split_run_callback(struct k_work *work) {
     struct zmk_split_run_behavior_payload_wrapper payload_wrapper;
 
@@ -767,6 +997,13 @@ void split_central_split_run_callback(struct k_work *work) {
             LOG_ERR("Source not connected");
             continue;
         }
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_BEHAVIOR_IDS)
+        if (batch_behavior_by_id(&payload_wrapper)) {
+            continue;
+        }
+        // Send anything batched for this peripheral first to keep the invocation order.
+        flush_behavior_id_batch(payload_wrapper.source);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_BEHAVIOR_IDS)
         if (!peripherals[payload_wrapper.source].run_behavior_handle) {
             LOG_ERR("Run behavior handle not found");
             continue;
@@ -781,6 +1018,12 @@ void split_central_split_run_callback(struct k_work *work) {
             LOG_ERR("Failed to write the behavior characteristic (err %d)", err);
         }
     }
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_BEHAVIOR_IDS)
+    for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
+        flush_behavior_id_batch(i);
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_BEHAVIOR_IDS)
 }
 
 K_WORK_DEFINE(split_central_split_run_work, split_central_split_run_callback);
@@ -825,6 +1068,9 @@ int zmk_split_bt_invoke_behavior(uint8_t source, struct zmk_behavior_binding *bi
     }
 
     struct zmk_split_run_behavior_payload_wrapper wrapper = {.source = source, .payload = payload};
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_BEHAVIOR_IDS)
+    wrapper.behavior_index = local_behavior_index(binding->behavior_dev);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_BEHAVIOR_IDS)
     return split_bt_invoke_behavior_payload(wrapper);
 }
 
@@ -865,6 +1111,37 @@ int zmk_split_bt_update_hid_indicator(zmk_hid_indicators_t indicators) {
 
 #endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
 
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_CONN_GOVERNOR)
+
+void zmk_split_bt_central_update_conn_param(const struct bt_le_conn_param *param) {
+    for (int i = 0; i < ZMK_SPLIT_BLE_PERIPHERAL_COUNT; i++) {
+        if (peripherals[i].state != PERIPHERAL_SLOT_STATE_CONNECTED) {
+            continue;
+        }
+
+        int err = bt_conn_le_param_update(peripherals[i].conn, param);
+        if (err < 0) {
+            LOG_WRN("Failed to update connection params for peripheral %d (err %d)", i, err);
+        }
+    }
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_CENTRAL_CONN_GOVERNOR)
+
+static bool split_bt_is_peripheral_connected(uint8_t source) {
+    return peripherals[source].state == PERIPHERAL_SLOT_STATE_CONNECTED;
+}
+
+static const struct zmk_split_transport_central_api split_bt_central_api = {
+    .invoke_behavior = zmk_split_bt_invoke_behavior,
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+    .update_hid_indicator = zmk_split_bt_update_hid_indicator,
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+    .is_peripheral_connected = split_bt_is_peripheral_connected,
+};
+
+ZMK_SPLIT_TRANSPORT_CENTRAL_DEFINE(&split_bt_central_api, ZMK_SPLIT_BLE_PERIPHERAL_COUNT);
+
 static int zmk_split_bt_central_init(void) {
     k_work_queue_start(&split_central_split_run_q, split_central_split_run_q_stack,
                        K_THREAD_STACK_SIZEOF(split_central_split_run_q_stack),
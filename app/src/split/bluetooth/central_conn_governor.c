@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/bluetooth/conn.h>
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/activity.h>
+#include <zmk/split/bluetooth/central.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/activity_state_changed.h>
+#include <zmk/events/position_state_changed.h>
+#include <zmk/events/sensor_event.h>
+
+enum governor_mode {
+    GOVERNOR_MODE_ACTIVE,
+    GOVERNOR_MODE_IDLE,
+};
+
+#define IDLE_MS CONFIG_ZMK_SPLIT_BLE_CENTRAL_CONN_GOVERNOR_IDLE_MS
+#define HOLDOFF_MS CONFIG_ZMK_SPLIT_BLE_CENTRAL_CONN_GOVERNOR_HOLDOFF_MS
+
+#define GOVERNOR_PARAM(_int, _latency)                                                             \
+    BT_LE_CONN_PARAM_INIT(_int, _int, _latency, CONFIG_ZMK_SPLIT_BLE_PREF_TIMEOUT)
+
+static const struct bt_le_conn_param mode_params[] = {
+    [GOVERNOR_MODE_ACTIVE] =
+        GOVERNOR_PARAM(CONFIG_ZMK_SPLIT_BLE_CENTRAL_CONN_GOVERNOR_ACTIVE_INT,
+                       CONFIG_ZMK_SPLIT_BLE_CENTRAL_CONN_GOVERNOR_ACTIVE_LATENCY),
+    [GOVERNOR_MODE_IDLE] = GOVERNOR_PARAM(CONFIG_ZMK_SPLIT_BLE_CENTRAL_CONN_GOVERNOR_IDLE_INT,
+                                          CONFIG_ZMK_SPLIT_BLE_CENTRAL_CONN_GOVERNOR_IDLE_LATENCY),
+};
+
+// Peripherals usually connect while the keyboard is in use, so start out active.
+static enum governor_mode mode = GOVERNOR_MODE_ACTIVE;
+static int64_t mode_since;
+static int64_t last_update;
+
+static uint32_t mode_ms[2];
+static uint32_t updates;
+
+// Set by the event listener, so an event is counted as activity even if the governor runs before
+// the activity tracker has seen it.
+static atomic_t activity_pending;
+
+static void governor_work_callback(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(governor_work, governor_work_callback);
+
+const struct bt_le_conn_param *zmk_split_bt_central_conn_governor_param(void) {
+    return &mode_params[mode];
+}
+
+void zmk_split_bt_central_conn_governor_get_stats(
+    struct zmk_split_bt_central_conn_governor_stats *stats) {
+    uint32_t current_ms = k_uptime_get() - mode_since;
+
+    stats->active_ms = mode_ms[GOVERNOR_MODE_ACTIVE];
+    stats->idle_ms = mode_ms[GOVERNOR_MODE_IDLE];
+    stats->updates = updates;
+
+    if (mode == GOVERNOR_MODE_ACTIVE) {
+        stats->active_ms += current_ms;
+    } else {
+        stats->idle_ms += current_ms;
+    }
+}
+
+static void set_mode(enum governor_mode new_mode, int64_t now) {
+    mode_ms[mode] += now - mode_since;
+    mode = new_mode;
+    mode_since = now;
+    last_update = now;
+    updates++;
+
+    LOG_DBG("Switching split connections to %s params",
+            new_mode == GOVERNOR_MODE_ACTIVE ? "active" : "idle");
+    zmk_split_bt_central_update_conn_param(&mode_params[new_mode]);
+}
+
+static void governor_work_callback(struct k_work *work) {
+    int64_t now = k_uptime_get();
+    int32_t inactive_time = zmk_activity_get_inactive_time();
+
+    if (atomic_clear(&activity_pending)) {
+        inactive_time = 0;
+    }
+
+    enum governor_mode wanted =
+        inactive_time >= IDLE_MS ? GOVERNOR_MODE_IDLE : GOVERNOR_MODE_ACTIVE;
+
+    // Each update costs a few connection events on both halves, so bursts of activity around the
+    // idle threshold are not allowed to flip the parameters back and forth.
+    int64_t holdoff = last_update + HOLDOFF_MS - now;
+    if (wanted != mode && holdoff > 0) {
+        if (wanted == GOVERNOR_MODE_ACTIVE) {
+            atomic_set(&activity_pending, 1);
+        }
+        k_work_reschedule(&governor_work, K_MSEC(holdoff));
+        return;
+    }
+
+    if (wanted != mode) {
+        set_mode(wanted, now);
+    }
+
+    // Check again when the idle threshold would be reached without further activity.
+    if (mode == GOVERNOR_MODE_ACTIVE) {
+        k_work_reschedule(&governor_work, K_MSEC(IDLE_MS - inactive_time));
+    }
+}
+
+static int governor_listener(const zmk_event_t *eh) {
+    const struct zmk_activity_state_changed *activity_ev = as_zmk_activity_state_changed(eh);
+    if (activity_ev != NULL) {
+        if (activity_ev->state != ZMK_ACTIVITY_ACTIVE && mode == GOVERNOR_MODE_ACTIVE) {
+            k_work_reschedule(&governor_work, K_NO_WAIT);
+        }
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    // While active, the scheduled check picks up new activity from the tracker on its own.
+    if (mode == GOVERNOR_MODE_IDLE) {
+        atomic_set(&activity_pending, 1);
+        k_work_reschedule(&governor_work, K_NO_WAIT);
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(split_central_conn_governor, governor_listener);
+ZMK_SUBSCRIPTION(split_central_conn_governor, zmk_position_state_changed);
+ZMK_SUBSCRIPTION(split_central_conn_governor, zmk_sensor_event);
+ZMK_SUBSCRIPTION(split_central_conn_governor, zmk_activity_state_changed);
+
+static int governor_init(void) {
+    k_work_schedule(&governor_work, K_MSEC(IDLE_MS));
+    return 0;
+}
+
+SYS_INIT(governor_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
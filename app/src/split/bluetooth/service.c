@@ -21,6 +21,8 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/matrix.h>
 #include <zmk/split/bluetooth/uuid.h>
 #include <zmk/split/bluetooth/service.h>
+#include <zmk/split/bluetooth/peripheral.h>
+#include <zmk/split/transport/peripheral.h>
 
 #if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
 #include <zmk/events/hid_indicators_changed.h>
@@ -28,6 +30,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 
 #include <zmk/events/sensor_event.h>
 #include <zmk/sensors.h>
+#include <zmk/workqueue.h>
 
 #if ZMK_KEYMAP_HAS_SENSORS
 static struct sensor_event last_sensor_event;
@@ -43,10 +46,8 @@ static void split_svc_sensor_state_ccc(const struct bt_gatt_attr *attr, uint16_t
 }
 #endif /* ZMK_KEYMAP_HAS_SENSORS */
 
-#define POS_STATE_LEN 16
-
 static uint8_t num_of_positions = ZMK_KEYMAP_LEN;
-static uint8_t position_state[POS_STATE_LEN];
+static uint8_t position_state[ZMK_SPLIT_POSITION_STATE_LEN];
 
 static struct zmk_split_run_behavior_payload behavior_run_payload;
 
@@ -56,6 +57,17 @@ static ssize_t split_svc_pos_state(struct bt_conn *conn, const struct bt_gatt_at
                              sizeof(position_state));
 }
 
+static void run_behavior(const char *behavior_dev, const struct zmk_split_run_behavior_data *data) {
+    struct zmk_behavior_binding binding = {
+        .param1 = data->param1,
+        .param2 = data->param2,
+        .behavior_dev = (char *)behavior_dev,
+    };
+    struct zmk_behavior_binding_event event = {.position = data->position,
+                                               .timestamp = k_uptime_get()};
+    zmk_split_peripheral_run_behavior(&binding, event, data->state > 0);
+}
+
 static ssize_t split_svc_run_behavior(struct bt_conn *conn, const struct bt_gatt_attr *attrs,
                                       const void *buf, uint16_t len, uint16_t offset,
                                       uint8_t flags) {
@@ -77,29 +89,96 @@ static ssize_t split_svc_run_behavior(struct bt_conn *conn, const struct bt_gatt
         offsetof(struct zmk_split_run_behavior_payload, behavior_dev);
     if ((end_addr > sizeof(struct zmk_split_run_behavior_data)) &&
         payload->behavior_dev[end_addr - behavior_dev_offset - 1] == '\0') {
-        struct zmk_behavior_binding binding = {
-            .param1 = payload->data.param1,
-            .param2 = payload->data.param2,
-            .behavior_dev = payload->behavior_dev,
-        };
-        LOG_DBG("%s with params %d %d: pressed? %d", binding.behavior_dev, binding.param1,
-                binding.param2, payload->data.state);
-        struct zmk_behavior_binding_event event = {.position = payload->data.position,
-                                                   .timestamp = k_uptime_get()};
-        int err;
-        if (payload->data.state > 0) {
-            err = behavior_keymap_binding_pressed(&binding, event);
-        } else {
-            err = behavior_keymap_binding_released(&binding, event);
+        run_behavior(payload->behavior_dev, &payload->data);
+    }
+
+    return len;
+}
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_BEHAVIOR_IDS)
+// The names list is a single attribute value, so it stops at the last name that fits in the ATT
+// attribute value limit. Behaviors past it get no ID, and the central invokes them by name.
+static ptrdiff_t behavior_id_count(void) {
+    static ptrdiff_t id_count = -1;
+    if (id_count >= 0) {
+        return id_count;
+    }
+
+    ptrdiff_t count;
+    STRUCT_SECTION_COUNT(zmk_behavior_ref, &count);
+    // The last ID is reserved for ZMK_SPLIT_BEHAVIOR_ID_UNKNOWN.
+    count = MIN(count, ZMK_SPLIT_BEHAVIOR_ID_UNKNOWN);
+
+    size_t names_len = 0;
+    for (id_count = 0; id_count < count; id_count++) {
+        const struct zmk_behavior_ref *ref;
+        STRUCT_SECTION_GET(zmk_behavior_ref, id_count, &ref);
+
+        names_len += strlen(ref->device->name) + 1;
+        if (names_len > BT_ATT_MAX_ATTRIBUTE_LEN) {
+            LOG_WRN("Only the first %d behaviors fit in the behavior names list", id_count);
+            break;
         }
+    }
 
-        if (err) {
-            LOG_ERR("Failed to invoke behavior %s: %d", binding.behavior_dev, err);
+    return id_count;
+}
+
+static ssize_t split_svc_behavior_names(struct bt_conn *conn, const struct bt_gatt_attr *attrs,
+                                        void *buf, uint16_t len, uint16_t offset) {
+    // The names are serialized on the fly, so each read only walks the behaviors.
+    size_t names_len = 0;
+    uint16_t written = 0;
+
+    for (ptrdiff_t i = 0; i < behavior_id_count(); i++) {
+        const struct zmk_behavior_ref *ref;
+        STRUCT_SECTION_GET(zmk_behavior_ref, i, &ref);
+
+        const char *name = ref->device->name;
+        const size_t name_len = strlen(name) + 1;
+
+        for (size_t j = 0; j < name_len && written < len; j++) {
+            if (names_len + j >= offset) {
+                ((uint8_t *)buf)[written++] = name[j];
+            }
         }
+
+        names_len += name_len;
+    }
+
+    if (offset > names_len) {
+        return BT_GATT_ERR(BT_ATT_ERR_INVALID_OFFSET);
+    }
+
+    return written;
+}
+
+static ssize_t split_svc_run_behavior_by_id(struct bt_conn *conn, const struct bt_gatt_attr *attrs,
+                                            const void *buf, uint16_t len, uint16_t offset,
+                                            uint8_t flags) {
+    const size_t payload_len = sizeof(struct zmk_split_run_behavior_id_payload);
+
+    if (offset != 0 || len % payload_len != 0) {
+        return BT_GATT_ERR(BT_ATT_ERR_INVALID_ATTRIBUTE_LEN);
+    }
+
+    for (uint16_t i = 0; i < len; i += payload_len) {
+        struct zmk_split_run_behavior_id_payload payload;
+        memcpy(&payload, (const uint8_t *)buf + i, payload_len);
+
+        if (payload.behavior_id >= behavior_id_count()) {
+            LOG_ERR("Invalid behavior ID %d", payload.behavior_id);
+            continue;
+        }
+
+        const struct zmk_behavior_ref *ref;
+        STRUCT_SECTION_GET(zmk_behavior_ref, payload.behavior_id, &ref);
+        run_behavior(ref->device->name, &payload.data);
     }
 
     return len;
 }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_BEHAVIOR_IDS)
 
 static ssize_t split_svc_num_of_positions(struct bt_conn *conn, const struct bt_gatt_attr *attrs,
                                           void *buf, uint16_t len, uint16_t offset) {
@@ -131,7 +210,7 @@ static ssize_t split_svc_update_indicators(struct bt_conn *conn, const struct bt
 
     memcpy((uint8_t *)&hid_indicators + offset, buf, len);
 
-    k_work_submit(&split_svc_update_indicators_work);
+    k_work_submit_to_queue(zmk_workqueue_input_work_q(), &split_svc_update_indicators_work);
 
     return len;
 }
@@ -160,17 +239,25 @@ BT_GATT_SERVICE_DEFINE(
                            BT_GATT_CHRC_WRITE_WITHOUT_RESP, BT_GATT_PERM_WRITE_ENCRYPT, NULL,
                            split_svc_update_indicators, NULL),
 #endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_BEHAVIOR_IDS)
+    BT_GATT_CHARACTERISTIC(BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_BEHAVIOR_NAMES_UUID),
+                           BT_GATT_CHRC_READ, BT_GATT_PERM_READ_ENCRYPT, split_svc_behavior_names,
+                           NULL, NULL),
+    BT_GATT_CHARACTERISTIC(BT_UUID_DECLARE_128(ZMK_SPLIT_BT_CHAR_RUN_BEHAVIOR_BY_ID_UUID),
+                           BT_GATT_CHRC_WRITE_WITHOUT_RESP, BT_GATT_PERM_WRITE_ENCRYPT, NULL,
+                           split_svc_run_behavior_by_id, NULL),
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_BLE_BEHAVIOR_IDS)
 );
 
 K_THREAD_STACK_DEFINE(service_q_stack, CONFIG_ZMK_SPLIT_BLE_PERIPHERAL_STACK_SIZE);
 
 struct k_work_q service_work_q;
 
-K_MSGQ_DEFINE(position_state_msgq, sizeof(char[POS_STATE_LEN]),
+K_MSGQ_DEFINE(position_state_msgq, sizeof(char[ZMK_SPLIT_POSITION_STATE_LEN]),
               CONFIG_ZMK_SPLIT_BLE_PERIPHERAL_POSITION_QUEUE_SIZE, 4);
 
 void send_position_state_callback(struct k_work *work) {
-    uint8_t state[POS_STATE_LEN];
+    uint8_t state[ZMK_SPLIT_POSITION_STATE_LEN];
 
     while (k_msgq_get(&position_state_msgq, &state, K_NO_WAIT) == 0) {
         int err = bt_gatt_notify(NULL, &split_svc.attrs[1], &state, sizeof(state));
@@ -182,15 +269,17 @@ void send_position_state_callback(struct k_work *work) {
 
 K_WORK_DEFINE(service_position_notify_work, send_position_state_callback);
 
-int send_position_state() {
+static int send_position_state(const uint8_t state[ZMK_SPLIT_POSITION_STATE_LEN]) {
+    memcpy(position_state, state, sizeof(position_state));
+
     int err = k_msgq_put(&position_state_msgq, position_state, K_MSEC(100));
     if (err) {
         switch (err) {
         case -EAGAIN: {
             LOG_WRN("Position state message queue full, popping first message and queueing again");
-            uint8_t discarded_state[POS_STATE_LEN];
+            uint8_t discarded_state[ZMK_SPLIT_POSITION_STATE_LEN];
             k_msgq_get(&position_state_msgq, &discarded_state, K_NO_WAIT);
-            return send_position_state();
+            return send_position_state(state);
         }
         default:
             LOG_WRN("Failed to queue position state to send (%d)", err);
@@ -203,15 +292,6 @@ int send_position_state() {
     return 0;
 }
 
-int zmk_split_bt_position_pressed(uint8_t position) {
-    WRITE_BIT(position_state[position / 8], position % 8, true);
-    return send_position_state();
-}
-
-int zmk_split_bt_position_released(uint8_t position) {
-    WRITE_BIT(position_state[position / 8], position % 8, false);
-    return send_position_state();
-}
 
 #if ZMK_KEYMAP_HAS_SENSORS
 K_MSGQ_DEFINE(sensor_state_msgq, sizeof(struct sensor_event),
@@ -250,21 +330,26 @@ int send_sensor_state(struct sensor_event ev) {
     return 0;
 }
 
-int zmk_split_bt_sensor_triggered(uint8_t sensor_index,
-                                  const struct zmk_sensor_channel_data channel_data[],
-                                  size_t channel_data_size) {
-    if (channel_data_size > ZMK_SENSOR_EVENT_MAX_CHANNELS) {
-        return -EINVAL;
-    }
-
-    struct sensor_event ev =
-        (struct sensor_event){.sensor_index = sensor_index, .channel_data_size = channel_data_size};
-    memcpy(ev.channel_data, channel_data,
-           channel_data_size * sizeof(struct zmk_sensor_channel_data));
+static int send_sensor_event(const struct zmk_sensor_event *sensor_ev) {
+    struct sensor_event ev = {.sensor_index = sensor_ev->sensor_index,
+                              .channel_data_size = sensor_ev->channel_data_size};
+    memcpy(ev.channel_data, sensor_ev->channel_data,
+           sensor_ev->channel_data_size * sizeof(struct zmk_sensor_channel_data));
     return send_sensor_state(ev);
 }
 #endif /* ZMK_KEYMAP_HAS_SENSORS */
 
+static const struct zmk_split_transport_peripheral_api split_bt_peripheral_api = {
+    .send_position_state = send_position_state,
+#if ZMK_KEYMAP_HAS_SENSORS
+    .send_sensor_event = send_sensor_event,
+#endif /* ZMK_KEYMAP_HAS_SENSORS */
+    // The battery level is exposed to the central through the battery service instead.
+    .is_connected = zmk_split_bt_peripheral_is_connected,
+};
+
+ZMK_SPLIT_TRANSPORT_PERIPHERAL_DEFINE(&split_bt_peripheral_api);
+
 static int service_init(void) {
     static const struct k_work_queue_config queue_config = {
         .name = "Split Peripheral Notification Queue"};
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+
+#include <string.h>
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/split/transport/central.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/position_state_changed.h>
+
+extern const struct zmk_split_transport_central zmk_split_transport_central_impl;
+
+static const struct zmk_split_transport_central *transport = &zmk_split_transport_central_impl;
+
+uint8_t zmk_split_central_peripheral_count(void) { return transport->peripheral_count; }
+
+bool zmk_split_central_is_peripheral_connected(uint8_t source) {
+    if (source >= transport->peripheral_count) {
+        return false;
+    }
+
+    return transport->api->is_peripheral_connected(source);
+}
+
+int zmk_split_central_invoke_behavior(uint8_t source, struct zmk_behavior_binding *binding,
+                                      struct zmk_behavior_binding_event event, bool state) {
+    if (source >= transport->peripheral_count) {
+        return -EINVAL;
+    }
+
+    return transport->api->invoke_behavior(source, binding, event, state);
+}
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+
+int zmk_split_central_update_hid_indicator(zmk_hid_indicators_t indicators) {
+    return transport->api->update_hid_indicator(indicators);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN)
+
+// Transports may report position states from their own threads, while retries run on the input
+// work queue. The mutex is recursive, so retries can apply the pending states while holding it.
+static K_MUTEX_DEFINE(position_state_mutex);
+
+// The latest state from each peripheral with changes that did not fit in its fan-in queue.
+static struct {
+    uint8_t state[ZMK_SPLIT_POSITION_STATE_LEN];
+    uint8_t *last_state;
+} pending_position_states[ZMK_SPLIT_CENTRAL_MAX_PERIPHERALS];
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN)
+
+void zmk_split_central_position_state_received(uint8_t source,
+                                               const uint8_t state[ZMK_SPLIT_POSITION_STATE_LEN],
+                                               uint8_t last_state[ZMK_SPLIT_POSITION_STATE_LEN]) {
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN)
+    bool deferred = false;
+    k_mutex_lock(&position_state_mutex, K_FOREVER);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN)
+
+    for (int i = 0; i < ZMK_SPLIT_POSITION_STATE_LEN; i++) {
+        uint8_t changed = state[i] ^ last_state[i];
+
+        for (int j = 0; j < 8; j++) {
+            if (changed & BIT(j)) {
+                struct zmk_position_state_changed ev = {.source = source,
+                                                        .position = (i * 8) + j,
+                                                        .state = state[i] & BIT(j),
+                                                        .timestamp = k_uptime_get()};
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN)
+                // Changes that were not queued stay out of last_state, so they are raised once
+                // the queue has room instead of leaving the key stuck.
+                if (zmk_split_central_fan_in_position_state_changed(ev) != 0) {
+                    deferred = true;
+                    continue;
+                }
+#else
+                LOG_DBG("Trigger key position state change for %d", ev.position);
+                raise_zmk_position_state_changed(ev);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN)
+                WRITE_BIT(last_state[i], j, state[i] & BIT(j));
+            }
+        }
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN)
+    if (source < ZMK_SPLIT_CENTRAL_MAX_PERIPHERALS) {
+        pending_position_states[source].last_state = deferred ? last_state : NULL;
+        memcpy(pending_position_states[source].state, state, ZMK_SPLIT_POSITION_STATE_LEN);
+    }
+    k_mutex_unlock(&position_state_mutex);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN)
+}
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN)
+
+void zmk_split_central_position_state_retry(void) {
+    k_mutex_lock(&position_state_mutex, K_FOREVER);
+    for (int i = 0; i < ZMK_SPLIT_CENTRAL_MAX_PERIPHERALS; i++) {
+        if (pending_position_states[i].last_state != NULL) {
+            uint8_t state[ZMK_SPLIT_POSITION_STATE_LEN];
+            memcpy(state, pending_position_states[i].state, sizeof(state));
+            zmk_split_central_position_state_received(i, state,
+                                                      pending_position_states[i].last_state);
+        }
+    }
+    k_mutex_unlock(&position_state_mutex);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN)
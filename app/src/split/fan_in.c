@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/split/transport/central.h>
+#include <zmk/workqueue.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/position_state_changed.h>
+#include <zmk/events/sensor_event.h>
+#include <zmk/events/battery_state_changed.h>
+
+enum fan_in_event_type {
+    FAN_IN_EVENT_POSITION,
+    FAN_IN_EVENT_SENSOR,
+    FAN_IN_EVENT_BATTERY,
+};
+
+struct fan_in_event {
+    int64_t timestamp;
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN_STATS)
+    uint32_t queued_cycles;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN_STATS)
+    uint8_t source;
+    enum fan_in_event_type type;
+    union {
+        struct zmk_position_state_changed position;
+        struct zmk_sensor_event sensor;
+#if IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+        struct zmk_peripheral_battery_state_changed battery;
+#endif // IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+    };
+};
+
+// Key position events and everything else are queued separately for each peripheral, so one
+// peripheral streaming sensor data can't hold up key events from the others.
+static struct k_msgq key_queues[ZMK_SPLIT_CENTRAL_MAX_PERIPHERALS];
+static struct k_msgq aux_queues[ZMK_SPLIT_CENTRAL_MAX_PERIPHERALS];
+
+static char __aligned(8) key_queue_bufs[ZMK_SPLIT_CENTRAL_MAX_PERIPHERALS]
+                                       [CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN_KEY_QUEUE_SIZE *
+                                        sizeof(struct fan_in_event)];
+static char __aligned(8) aux_queue_bufs[ZMK_SPLIT_CENTRAL_MAX_PERIPHERALS]
+                                       [CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN_AUX_QUEUE_SIZE *
+                                        sizeof(struct fan_in_event)];
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN_STATS)
+
+static struct zmk_split_central_fan_in_stats stats[ZMK_SPLIT_CENTRAL_MAX_PERIPHERALS];
+
+int zmk_split_central_fan_in_get_stats(uint8_t source,
+                                       struct zmk_split_central_fan_in_stats *source_stats) {
+    if (source >= ZMK_SPLIT_CENTRAL_MAX_PERIPHERALS) {
+        return -EINVAL;
+    }
+
+    *source_stats = stats[source];
+    return 0;
+}
+
+static void record_queued(uint8_t source) {
+    uint32_t depth =
+        k_msgq_num_used_get(&key_queues[source]) + k_msgq_num_used_get(&aux_queues[source]);
+    stats[source].max_queue_depth = MAX(stats[source].max_queue_depth, depth);
+}
+
+static void record_raised(const struct fan_in_event *ev) {
+    uint32_t latency_us = k_cyc_to_us_floor32(k_cycle_get_32() - ev->queued_cycles);
+
+    stats[ev->source].raised++;
+    stats[ev->source].last_latency_us = latency_us;
+    stats[ev->source].max_latency_us = MAX(stats[ev->source].max_latency_us, latency_us);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN_STATS)
+
+// Finds the queue whose next event was received first. Ties go to the lower source.
+static struct k_msgq *oldest_queue(struct k_msgq queues[], int64_t *timestamp) {
+    struct k_msgq *oldest = NULL;
+
+    for (int i = 0; i < ZMK_SPLIT_CENTRAL_MAX_PERIPHERALS; i++) {
+        struct fan_in_event ev;
+        if (k_msgq_peek(&queues[i], &ev) == 0 && (oldest == NULL || ev.timestamp < *timestamp)) {
+            oldest = &queues[i];
+            *timestamp = ev.timestamp;
+        }
+    }
+
+    return oldest;
+}
+
+// Key events are raised ahead of sensor and battery events, unless that would move them ahead of
+// one received more than the reorder window earlier.
+static struct k_msgq *next_queue(void) {
+    int64_t key_timestamp = 0, aux_timestamp = 0;
+    struct k_msgq *key_queue = oldest_queue(key_queues, &key_timestamp);
+    struct k_msgq *aux_queue = oldest_queue(aux_queues, &aux_timestamp);
+
+    if (key_queue == NULL) {
+        return aux_queue;
+    }
+
+    if (aux_queue != NULL &&
+        aux_timestamp + CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN_REORDER_WINDOW_MS <= key_timestamp) {
+        return aux_queue;
+    }
+
+    return key_queue;
+}
+
+static void raise_fan_in_event(struct fan_in_event *ev) {
+    switch (ev->type) {
+    case FAN_IN_EVENT_POSITION:
+        LOG_DBG("Trigger key position state change for %d", ev->position.position);
+        raise_zmk_position_state_changed(ev->position);
+        break;
+    case FAN_IN_EVENT_SENSOR:
+        LOG_DBG("Trigger sensor change for %d", ev->sensor.sensor_index);
+        raise_zmk_sensor_event(ev->sensor);
+        break;
+#if IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+    case FAN_IN_EVENT_BATTERY:
+        LOG_DBG("Triggering peripheral battery level change %u", ev->battery.state_of_charge);
+        raise_zmk_peripheral_battery_state_changed(ev->battery);
+        break;
+#endif // IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+    default:
+        break;
+    }
+}
+
+static void fan_in_work_callback(struct k_work *work) {
+    struct k_msgq *queue;
+    struct fan_in_event ev;
+
+    // Pick again after every event, so key events queued meanwhile get ahead of the rest.
+    while ((queue = next_queue()) != NULL) {
+        if (k_msgq_get(queue, &ev, K_NO_WAIT) != 0) {
+            continue;
+        }
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN_STATS)
+        record_raised(&ev);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN_STATS)
+        raise_fan_in_event(&ev);
+    }
+
+    zmk_split_central_position_state_retry();
+}
+
+K_WORK_DEFINE(fan_in_work, fan_in_work_callback);
+
+static int queue_event(struct k_msgq queues[], struct fan_in_event *ev) {
+    if (ev->source >= ZMK_SPLIT_CENTRAL_MAX_PERIPHERALS) {
+        return -EINVAL;
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN_STATS)
+    ev->queued_cycles = k_cycle_get_32();
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN_STATS)
+
+    int err = k_msgq_put(&queues[ev->source], ev, K_NO_WAIT);
+    if (err) {
+        LOG_WRN("Input queue for peripheral %d full, dropping event", ev->source);
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN_STATS)
+        stats[ev->source].dropped++;
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN_STATS)
+        return err;
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN_STATS)
+    record_queued(ev->source);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN_STATS)
+
+    k_work_submit_to_queue(zmk_workqueue_input_work_q(), &fan_in_work);
+    return 0;
+}
+
+int zmk_split_central_fan_in_position_state_changed(struct zmk_position_state_changed ev) {
+    struct fan_in_event fan_in_ev = {
+        .timestamp = ev.timestamp,
+        .source = ev.source,
+        .type = FAN_IN_EVENT_POSITION,
+        .position = ev,
+    };
+    return queue_event(key_queues, &fan_in_ev);
+}
+
+int zmk_split_central_fan_in_sensor_event(uint8_t source, struct zmk_sensor_event ev) {
+    struct fan_in_event fan_in_ev = {
+        .timestamp = ev.timestamp,
+        .source = source,
+        .type = FAN_IN_EVENT_SENSOR,
+        .sensor = ev,
+    };
+    return queue_event(aux_queues, &fan_in_ev);
+}
+
+#if IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+
+int zmk_split_central_fan_in_peripheral_battery_state_changed(
+    struct zmk_peripheral_battery_state_changed ev) {
+    struct fan_in_event fan_in_ev = {
+        .timestamp = k_uptime_get(),
+        .source = ev.source,
+        .type = FAN_IN_EVENT_BATTERY,
+        .battery = ev,
+    };
+    return queue_event(aux_queues, &fan_in_ev);
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+
+static int fan_in_init(void) {
+    for (int i = 0; i < ZMK_SPLIT_CENTRAL_MAX_PERIPHERALS; i++) {
+        k_msgq_init(&key_queues[i], key_queue_bufs[i], sizeof(struct fan_in_event),
+                    CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN_KEY_QUEUE_SIZE);
+        k_msgq_init(&aux_queues[i], aux_queue_bufs[i], sizeof(struct fan_in_event),
+                    CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN_AUX_QUEUE_SIZE);
+    }
+
+    return 0;
+}
+
+SYS_INIT(fan_in_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
@@ -0,0 +1,366 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/kscan.h>
+#include <zephyr/drivers/sensor.h>
+
+#include <string.h>
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/stdlib.h>
+#include <zmk/behavior.h>
+#include <zmk/sensors.h>
+#include <zmk/hid_indicators_types.h>
+#include <zmk/split/memory/memory.h>
+#include <zmk/workqueue.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/sensor_event.h>
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+#include <zmk/split/transport/central.h>
+#else
+#include <zmk/split/transport/peripheral.h>
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+
+#define BEHAVIOR_DEV_LEN 32
+
+enum split_memory_msg_type {
+    // Peripheral to central
+    SPLIT_MEMORY_MSG_POSITION_STATE,
+    SPLIT_MEMORY_MSG_SENSOR_EVENT,
+    SPLIT_MEMORY_MSG_BATTERY_LEVEL,
+    // Central to peripheral
+    SPLIT_MEMORY_MSG_RUN_BEHAVIOR,
+    SPLIT_MEMORY_MSG_HID_INDICATORS,
+};
+
+struct split_memory_run_behavior {
+    char behavior_dev[BEHAVIOR_DEV_LEN];
+    uint32_t param1;
+    uint32_t param2;
+    uint8_t position;
+    bool state;
+};
+
+struct split_memory_msg {
+    enum split_memory_msg_type type;
+    uint8_t source;
+    union {
+        uint8_t position_state[ZMK_SPLIT_POSITION_STATE_LEN];
+        struct zmk_sensor_event sensor_event;
+        uint8_t battery_level;
+        struct split_memory_run_behavior run_behavior;
+        zmk_hid_indicators_t hid_indicators;
+    };
+};
+
+K_MSGQ_DEFINE(split_memory_central_msgq, sizeof(struct split_memory_msg),
+              CONFIG_ZMK_SPLIT_MEMORY_QUEUE_SIZE, 4);
+
+// Messages sent within the latency of the first one waiting are received together, like
+// notifications sent between two connection events.
+static int send_msg(struct k_msgq *msgq, struct k_work_delayable *work,
+                    const struct split_memory_msg *msg) {
+    int err = k_msgq_put(msgq, msg, K_NO_WAIT);
+    if (err) {
+        LOG_WRN("Split memory queue full, dropping message of type %d", msg->type);
+        return err;
+    }
+
+    k_work_schedule_for_queue(zmk_workqueue_input_work_q(), work,
+                              K_MSEC(CONFIG_ZMK_SPLIT_MEMORY_LATENCY_MS));
+    return 0;
+}
+
+static void split_memory_central_receive(struct k_work *work);
+
+K_WORK_DELAYABLE_DEFINE(split_memory_central_work, split_memory_central_receive);
+
+static int send_to_central(const struct split_memory_msg *msg) {
+    return send_msg(&split_memory_central_msgq, &split_memory_central_work, msg);
+}
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+
+K_MSGQ_DEFINE(split_memory_peripheral_msgq, sizeof(struct split_memory_msg),
+              CONFIG_ZMK_SPLIT_MEMORY_QUEUE_SIZE, 4);
+
+static void split_memory_peripheral_receive(struct k_work *work);
+
+K_WORK_DELAYABLE_DEFINE(split_memory_peripheral_work, split_memory_peripheral_receive);
+
+static int send_to_peripheral(const struct split_memory_msg *msg) {
+    return send_msg(&split_memory_peripheral_msgq, &split_memory_peripheral_work, msg);
+}
+
+// The central's view of each peripheral, and the keys held on each simulated peripheral.
+static uint8_t position_state[ZMK_SPLIT_MEMORY_PERIPHERAL_COUNT][ZMK_SPLIT_POSITION_STATE_LEN];
+static uint8_t
+    peripheral_position_state[ZMK_SPLIT_MEMORY_PERIPHERAL_COUNT][ZMK_SPLIT_POSITION_STATE_LEN];
+
+static void split_memory_central_receive(struct k_work *work) {
+    struct split_memory_msg msg;
+    while (k_msgq_get(&split_memory_central_msgq, &msg, K_NO_WAIT) == 0) {
+        switch (msg.type) {
+        case SPLIT_MEMORY_MSG_POSITION_STATE:
+            zmk_split_central_position_state_received(msg.source, msg.position_state,
+                                                      position_state[msg.source]);
+            break;
+        case SPLIT_MEMORY_MSG_SENSOR_EVENT:
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN)
+            zmk_split_central_fan_in_sensor_event(msg.source, msg.sensor_event);
+#else
+            LOG_DBG("Trigger sensor change for %d", msg.sensor_event.sensor_index);
+            raise_zmk_sensor_event(msg.sensor_event);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN)
+            break;
+        default:
+            LOG_WRN("Ignoring unexpected message of type %d", msg.type);
+            break;
+        }
+    }
+}
+
+// The simulated peripherals only record what they are asked to do.
+static void split_memory_peripheral_receive(struct k_work *work) {
+    struct split_memory_msg msg;
+    while (k_msgq_get(&split_memory_peripheral_msgq, &msg, K_NO_WAIT) == 0) {
+        switch (msg.type) {
+        case SPLIT_MEMORY_MSG_RUN_BEHAVIOR:
+            LOG_DBG("peripheral %d: %s with params %d %d: pressed? %d", msg.source,
+                    msg.run_behavior.behavior_dev, msg.run_behavior.param1,
+                    msg.run_behavior.param2, msg.run_behavior.state);
+            break;
+        case SPLIT_MEMORY_MSG_HID_INDICATORS:
+            LOG_DBG("peripheral %d: HID indicators %x", msg.source, msg.hid_indicators);
+            break;
+        default:
+            LOG_WRN("Ignoring unexpected message of type %d", msg.type);
+            break;
+        }
+    }
+}
+
+int zmk_split_memory_peripheral_set_position(uint8_t source, uint32_t position, bool pressed) {
+    if (source >= ZMK_SPLIT_MEMORY_PERIPHERAL_COUNT ||
+        position >= ZMK_SPLIT_POSITION_STATE_LEN * 8) {
+        return -EINVAL;
+    }
+
+    WRITE_BIT(peripheral_position_state[source][position / 8], position % 8, pressed);
+
+    struct split_memory_msg msg = {.type = SPLIT_MEMORY_MSG_POSITION_STATE, .source = source};
+    memcpy(msg.position_state, peripheral_position_state[source], sizeof(msg.position_state));
+    return send_to_central(&msg);
+}
+
+#if DT_HAS_CHOSEN(zmk_split_memory_sensor)
+
+// Readings of the chosen sensor are sent as sensor 0 of the first simulated peripheral.
+static void split_memory_sensor_trigger_handler(const struct device *dev,
+                                                const struct sensor_trigger *trigger) {
+    struct sensor_value value;
+
+    int err = sensor_sample_fetch(dev);
+    if (!err) {
+        err = sensor_channel_get(dev, trigger->chan, &value);
+    }
+    if (err) {
+        LOG_WRN("Failed to read the simulated peripheral sensor (err %d)", err);
+        return;
+    }
+
+    struct split_memory_msg msg = {
+        .type = SPLIT_MEMORY_MSG_SENSOR_EVENT,
+        .source = 0,
+        .sensor_event = {.sensor_index = 0,
+                         .channel_data_size = 1,
+                         .channel_data = {{.value = value, .channel = trigger->chan}},
+                         .timestamp = k_uptime_get()},
+    };
+    send_to_central(&msg);
+}
+
+static const struct sensor_trigger split_memory_sensor_trigger = {
+    .type = SENSOR_TRIG_DATA_READY,
+    .chan = SENSOR_CHAN_ROTATION,
+};
+
+static int split_memory_sensor_init(void) {
+    const struct device *sensor = DEVICE_DT_GET(DT_CHOSEN(zmk_split_memory_sensor));
+
+    if (!device_is_ready(sensor)) {
+        LOG_ERR("Simulated peripheral sensor %s is not ready", sensor->name);
+        return -ENODEV;
+    }
+
+    return sensor_trigger_set(sensor, &split_memory_sensor_trigger,
+                              split_memory_sensor_trigger_handler);
+}
+
+SYS_INIT(split_memory_sensor_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+#endif // DT_HAS_CHOSEN(zmk_split_memory_sensor)
+
+#if DT_HAS_CHOSEN(zmk_split_memory_kscan)
+
+// Key changes on the chosen kscan are made on the simulated peripherals: the row selects the
+// peripheral, and the column is the key position.
+static void split_memory_kscan_callback(const struct device *dev, uint32_t row, uint32_t column,
+                                        bool pressed) {
+    int err = zmk_split_memory_peripheral_set_position(row, column, pressed);
+    if (err) {
+        LOG_WRN("Failed to change position %d on simulated peripheral %d (err %d)", column, row,
+                err);
+    }
+}
+
+static int split_memory_kscan_init(void) {
+    const struct device *kscan = DEVICE_DT_GET(DT_CHOSEN(zmk_split_memory_kscan));
+
+    if (!device_is_ready(kscan)) {
+        LOG_ERR("Simulated peripheral KSCAN device %s is not ready", kscan->name);
+        return -ENODEV;
+    }
+
+    kscan_config(kscan, split_memory_kscan_callback);
+    kscan_enable_callback(kscan);
+
+    return 0;
+}
+
+SYS_INIT(split_memory_kscan_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+#endif // DT_HAS_CHOSEN(zmk_split_memory_kscan)
+
+static int split_memory_invoke_behavior(uint8_t source, struct zmk_behavior_binding *binding,
+                                        struct zmk_behavior_binding_event event, bool state) {
+    struct split_memory_msg msg = {.type = SPLIT_MEMORY_MSG_RUN_BEHAVIOR,
+                                   .source = source,
+                                   .run_behavior = {
+                                       .param1 = binding->param1,
+                                       .param2 = binding->param2,
+                                       .position = event.position,
+                                       .state = state,
+                                   }};
+
+    const size_t dev_size = sizeof(msg.run_behavior.behavior_dev);
+    if (strlcpy(msg.run_behavior.behavior_dev, binding->behavior_dev, dev_size) >= dev_size) {
+        LOG_ERR("Truncated behavior label %s to %s before invoking peripheral behavior",
+                binding->behavior_dev, msg.run_behavior.behavior_dev);
+    }
+
+    return send_to_peripheral(&msg);
+}
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+
+static int split_memory_update_hid_indicator(zmk_hid_indicators_t indicators) {
+    for (int i = 0; i < ZMK_SPLIT_MEMORY_PERIPHERAL_COUNT; i++) {
+        struct split_memory_msg msg = {
+            .type = SPLIT_MEMORY_MSG_HID_INDICATORS, .source = i, .hid_indicators = indicators};
+        int err = send_to_peripheral(&msg);
+        if (err) {
+            return err;
+        }
+    }
+
+    return 0;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+
+static bool split_memory_is_peripheral_connected(uint8_t source) { return true; }
+
+static const struct zmk_split_transport_central_api split_memory_central_api = {
+    .invoke_behavior = split_memory_invoke_behavior,
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+    .update_hid_indicator = split_memory_update_hid_indicator,
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+    .is_peripheral_connected = split_memory_is_peripheral_connected,
+};
+
+ZMK_SPLIT_TRANSPORT_CENTRAL_DEFINE(&split_memory_central_api, ZMK_SPLIT_MEMORY_PERIPHERAL_COUNT);
+
+#else
+
+// The simulated central's view of this peripheral.
+static uint8_t position_state[ZMK_SPLIT_POSITION_STATE_LEN];
+
+// The simulated central only records what it receives.
+static void split_memory_central_receive(struct k_work *work) {
+    struct split_memory_msg msg;
+    while (k_msgq_get(&split_memory_central_msgq, &msg, K_NO_WAIT) == 0) {
+        switch (msg.type) {
+        case SPLIT_MEMORY_MSG_POSITION_STATE:
+            for (int i = 0; i < ZMK_SPLIT_POSITION_STATE_LEN; i++) {
+                uint8_t changed = msg.position_state[i] ^ position_state[i];
+                position_state[i] = msg.position_state[i];
+
+                for (int j = 0; j < 8; j++) {
+                    if (changed & BIT(j)) {
+                        LOG_DBG("position %d %s", (i * 8) + j,
+                                (position_state[i] & BIT(j)) ? "pressed" : "released");
+                    }
+                }
+            }
+            break;
+        case SPLIT_MEMORY_MSG_SENSOR_EVENT:
+            LOG_DBG("sensor %d", msg.sensor_event.sensor_index);
+            break;
+        case SPLIT_MEMORY_MSG_BATTERY_LEVEL:
+            LOG_DBG("battery level %d", msg.battery_level);
+            break;
+        default:
+            LOG_WRN("Ignoring unexpected message of type %d", msg.type);
+            break;
+        }
+    }
+}
+
+static int split_memory_send_position_state(const uint8_t state[ZMK_SPLIT_POSITION_STATE_LEN]) {
+    struct split_memory_msg msg = {.type = SPLIT_MEMORY_MSG_POSITION_STATE};
+    memcpy(msg.position_state, state, sizeof(msg.position_state));
+    return send_to_central(&msg);
+}
+
+#if ZMK_KEYMAP_HAS_SENSORS
+static int split_memory_send_sensor_event(const struct zmk_sensor_event *ev) {
+    struct split_memory_msg msg = {.type = SPLIT_MEMORY_MSG_SENSOR_EVENT, .sensor_event = *ev};
+    return send_to_central(&msg);
+}
+#endif /* ZMK_KEYMAP_HAS_SENSORS */
+
+#if IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+static int split_memory_send_battery_level(uint8_t level) {
+    struct split_memory_msg msg = {.type = SPLIT_MEMORY_MSG_BATTERY_LEVEL, .battery_level = level};
+    return send_to_central(&msg);
+}
+#endif // IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+
+static bool split_memory_is_connected(void) { return true; }
+
+static const struct zmk_split_transport_peripheral_api split_memory_peripheral_api = {
+    .send_position_state = split_memory_send_position_state,
+#if ZMK_KEYMAP_HAS_SENSORS
+    .send_sensor_event = split_memory_send_sensor_event,
+#endif /* ZMK_KEYMAP_HAS_SENSORS */
+#if IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+    .send_battery_level = split_memory_send_battery_level,
+#endif // IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+    .is_connected = split_memory_is_connected,
+};
+
+ZMK_SPLIT_TRANSPORT_PERIPHERAL_DEFINE(&split_memory_peripheral_api);
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
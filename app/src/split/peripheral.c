@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2020 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/device.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <drivers/behavior.h>
+#include <zmk/split/transport/peripheral.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/position_state_changed.h>
+#include <zmk/events/sensor_event.h>
+#include <zmk/events/battery_state_changed.h>
+#include <zmk/sensors.h>
+
+extern const struct zmk_split_transport_peripheral zmk_split_transport_peripheral_impl;
+
+static const struct zmk_split_transport_peripheral *transport =
+    &zmk_split_transport_peripheral_impl;
+
+static uint8_t position_state[ZMK_SPLIT_POSITION_STATE_LEN];
+
+bool zmk_split_peripheral_is_connected(void) { return transport->api->is_connected(); }
+
+int zmk_split_peripheral_run_behavior(struct zmk_behavior_binding *binding,
+                                      struct zmk_behavior_binding_event event, bool state) {
+    LOG_DBG("%s with params %d %d: pressed? %d", binding->behavior_dev, binding->param1,
+            binding->param2, state);
+
+    int err;
+    if (state) {
+        err = behavior_keymap_binding_pressed(binding, event);
+    } else {
+        err = behavior_keymap_binding_released(binding, event);
+    }
+
+    if (err) {
+        LOG_ERR("Failed to invoke behavior %s: %d", binding->behavior_dev, err);
+    }
+
+    return err;
+}
+
+int split_listener(const zmk_event_t *eh) {
+    LOG_DBG("");
+    const struct zmk_position_state_changed *pos_ev;
+    if ((pos_ev = as_zmk_position_state_changed(eh)) != NULL) {
+        if (pos_ev->position >= ZMK_SPLIT_POSITION_STATE_LEN * 8) {
+            return -EINVAL;
+        }
+
+        WRITE_BIT(position_state[pos_ev->position / 8], pos_ev->position % 8, pos_ev->state);
+        return transport->api->send_position_state(position_state);
+    }
+
+#if ZMK_KEYMAP_HAS_SENSORS
+    const struct zmk_sensor_event *sensor_ev;
+    if ((sensor_ev = as_zmk_sensor_event(eh)) != NULL) {
+        if (sensor_ev->channel_data_size > ZMK_SENSOR_EVENT_MAX_CHANNELS) {
+            return -EINVAL;
+        }
+
+        return transport->api->send_sensor_event(sensor_ev);
+    }
+#endif /* ZMK_KEYMAP_HAS_SENSORS */
+
+#if IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+    const struct zmk_battery_state_changed *battery_ev;
+    if ((battery_ev = as_zmk_battery_state_changed(eh)) != NULL) {
+        if (transport->api->send_battery_level == NULL) {
+            return ZMK_EV_EVENT_BUBBLE;
+        }
+
+        return transport->api->send_battery_level(battery_ev->state_of_charge);
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(split_listener, split_listener);
+ZMK_SUBSCRIPTION(split_listener, zmk_position_state_changed);
+
+#if ZMK_KEYMAP_HAS_SENSORS
+ZMK_SUBSCRIPTION(split_listener, zmk_sensor_event);
+#endif /* ZMK_KEYMAP_HAS_SENSORS */
+
+#if IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+ZMK_SUBSCRIPTION(split_listener, zmk_battery_state_changed);
+#endif // IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
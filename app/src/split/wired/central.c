@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+
+#include <string.h>
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/stdlib.h>
+#include <zmk/behavior.h>
+#include <zmk/sensors.h>
+#include <zmk/split/wired/wired.h>
+#include <zmk/split/wired/central.h>
+#include <zmk/split/transport/central.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/sensor_event.h>
+#include <zmk/events/battery_state_changed.h>
+
+static uint8_t position_state[ZMK_SPLIT_POSITION_STATE_LEN];
+
+static void handle_position_state(const struct zmk_split_wired_frame *frame) {
+    if (frame->len != ZMK_SPLIT_POSITION_STATE_LEN) {
+        LOG_WRN("Ignoring position state with invalid length (%d)", frame->len);
+        return;
+    }
+
+    zmk_split_central_position_state_received(0, frame->payload, position_state);
+}
+
+#if ZMK_KEYMAP_HAS_SENSORS
+static void handle_sensor_event(const struct zmk_split_wired_frame *frame) {
+    struct zmk_split_wired_sensor_payload payload = {0};
+
+    if (frame->len < offsetof(struct zmk_split_wired_sensor_payload, channel_data)) {
+        LOG_WRN("Ignoring sensor event with insufficient data length (%d)", frame->len);
+        return;
+    }
+
+    memcpy(&payload, frame->payload, MIN(frame->len, sizeof(payload)));
+    struct zmk_sensor_event ev = {
+        .sensor_index = payload.sensor_index,
+        .channel_data_size = MIN(payload.channel_data_size, ZMK_SENSOR_EVENT_MAX_CHANNELS),
+        .timestamp = k_uptime_get()};
+
+    memcpy(ev.channel_data, payload.channel_data,
+           sizeof(struct zmk_sensor_channel_data) * ev.channel_data_size);
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN)
+    zmk_split_central_fan_in_sensor_event(0, ev);
+#else
+    LOG_DBG("Trigger sensor change for %d", ev.sensor_index);
+    raise_zmk_sensor_event(ev);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN)
+}
+#endif /* ZMK_KEYMAP_HAS_SENSORS */
+
+#if IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+static uint8_t peripheral_battery_level;
+
+int zmk_split_wired_get_peripheral_battery_level(uint8_t source, uint8_t *level) {
+    if (source >= ZMK_SPLIT_WIRED_PERIPHERAL_COUNT) {
+        return -EINVAL;
+    }
+
+    *level = peripheral_battery_level;
+    return 0;
+}
+
+static void handle_battery_level(const struct zmk_split_wired_frame *frame) {
+    if (frame->len != sizeof(uint8_t)) {
+        LOG_WRN("Ignoring battery level with invalid length (%d)", frame->len);
+        return;
+    }
+
+    peripheral_battery_level = frame->payload[0];
+    LOG_DBG("Peripheral battery level %d", peripheral_battery_level);
+    struct zmk_peripheral_battery_state_changed ev = {.source = 0,
+                                                      .state_of_charge = peripheral_battery_level};
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN)
+    zmk_split_central_fan_in_peripheral_battery_state_changed(ev);
+#else
+    raise_zmk_peripheral_battery_state_changed(ev);
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_CENTRAL_FAN_IN)
+}
+#endif // IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+
+void zmk_split_wired_handle_frame(const struct zmk_split_wired_frame *frame) {
+    switch (frame->type) {
+    case ZMK_SPLIT_WIRED_MSG_POSITION_STATE:
+        handle_position_state(frame);
+        break;
+
+#if ZMK_KEYMAP_HAS_SENSORS
+    case ZMK_SPLIT_WIRED_MSG_SENSOR_EVENT:
+        handle_sensor_event(frame);
+        break;
+#endif /* ZMK_KEYMAP_HAS_SENSORS */
+
+#if IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+    case ZMK_SPLIT_WIRED_MSG_BATTERY_LEVEL:
+        handle_battery_level(frame);
+        break;
+#endif // IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+
+    default:
+        LOG_WRN("Ignoring unexpected split frame of type %d", frame->type);
+        break;
+    }
+}
+
+static int split_wired_invoke_behavior(uint8_t source, struct zmk_behavior_binding *binding,
+                                       struct zmk_behavior_binding_event event, bool state) {
+    struct zmk_split_wired_run_behavior_payload payload = {
+        .position = event.position,
+        .state = state ? 1 : 0,
+        .param1 = binding->param1,
+        .param2 = binding->param2,
+    };
+    const size_t payload_dev_size = sizeof(payload.behavior_dev);
+    if (strlcpy(payload.behavior_dev, binding->behavior_dev, payload_dev_size) >=
+        payload_dev_size) {
+        LOG_ERR("Truncated behavior label %s to %s before invoking peripheral behavior",
+                binding->behavior_dev, payload.behavior_dev);
+    }
+
+    size_t len = offsetof(struct zmk_split_wired_run_behavior_payload, behavior_dev) +
+                 strlen(payload.behavior_dev) + 1;
+    return zmk_split_wired_send(ZMK_SPLIT_WIRED_MSG_RUN_BEHAVIOR, &payload, len);
+}
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+
+static int split_wired_update_hid_indicator(zmk_hid_indicators_t indicators) {
+    return zmk_split_wired_send(ZMK_SPLIT_WIRED_MSG_HID_INDICATORS, &indicators,
+                                sizeof(indicators));
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+
+// A UART has no link state, so the peripheral is always considered connected.
+static bool split_wired_is_peripheral_connected(uint8_t source) { return true; }
+
+static const struct zmk_split_transport_central_api split_wired_central_api = {
+    .invoke_behavior = split_wired_invoke_behavior,
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+    .update_hid_indicator = split_wired_update_hid_indicator,
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+    .is_peripheral_connected = split_wired_is_peripheral_connected,
+};
+
+ZMK_SPLIT_TRANSPORT_CENTRAL_DEFINE(&split_wired_central_api, ZMK_SPLIT_WIRED_PERIPHERAL_COUNT);
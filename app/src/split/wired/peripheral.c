@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/kernel.h>
+
+#include <string.h>
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/behavior.h>
+#include <zmk/sensors.h>
+#include <zmk/split/wired/wired.h>
+#include <zmk/split/transport/peripheral.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/sensor_event.h>
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+#include <zmk/events/hid_indicators_changed.h>
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+
+BUILD_ASSERT(sizeof(struct zmk_split_wired_sensor_payload) <= ZMK_SPLIT_WIRED_MAX_PAYLOAD_LEN);
+BUILD_ASSERT(sizeof(struct zmk_split_wired_run_behavior_payload) <=
+             ZMK_SPLIT_WIRED_MAX_PAYLOAD_LEN);
+
+static void handle_run_behavior(const struct zmk_split_wired_frame *frame) {
+    struct zmk_split_wired_run_behavior_payload payload;
+    const size_t behavior_dev_offset =
+        offsetof(struct zmk_split_wired_run_behavior_payload, behavior_dev);
+
+    if (frame->len <= behavior_dev_offset || frame->len > sizeof(payload) ||
+        frame->payload[frame->len - 1] != '\0') {
+        LOG_WRN("Ignoring malformed run behavior frame (length %d)", frame->len);
+        return;
+    }
+
+    memcpy(&payload, frame->payload, frame->len);
+
+    struct zmk_behavior_binding binding = {
+        .param1 = payload.param1,
+        .param2 = payload.param2,
+        .behavior_dev = payload.behavior_dev,
+    };
+    struct zmk_behavior_binding_event event = {.position = payload.position,
+                                               .timestamp = k_uptime_get()};
+    zmk_split_peripheral_run_behavior(&binding, event, payload.state > 0);
+}
+
+void zmk_split_wired_handle_frame(const struct zmk_split_wired_frame *frame) {
+    switch (frame->type) {
+    case ZMK_SPLIT_WIRED_MSG_RUN_BEHAVIOR:
+        handle_run_behavior(frame);
+        break;
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+    case ZMK_SPLIT_WIRED_MSG_HID_INDICATORS: {
+        zmk_hid_indicators_t indicators = 0;
+        memcpy(&indicators, frame->payload, MIN(frame->len, sizeof(indicators)));
+        LOG_DBG("Raising HID indicators changed event: %x", indicators);
+        raise_zmk_hid_indicators_changed(
+            (struct zmk_hid_indicators_changed){.indicators = indicators});
+        break;
+    }
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_PERIPHERAL_HID_INDICATORS)
+
+    default:
+        LOG_WRN("Ignoring unexpected split frame of type %d", frame->type);
+        break;
+    }
+}
+
+static int split_wired_send_position_state(const uint8_t state[ZMK_SPLIT_POSITION_STATE_LEN]) {
+    return zmk_split_wired_send(ZMK_SPLIT_WIRED_MSG_POSITION_STATE, state,
+                                ZMK_SPLIT_POSITION_STATE_LEN);
+}
+
+#if ZMK_KEYMAP_HAS_SENSORS
+static int split_wired_send_sensor_event(const struct zmk_sensor_event *ev) {
+    struct zmk_split_wired_sensor_payload payload = {
+        .sensor_index = ev->sensor_index,
+        .channel_data_size = ev->channel_data_size,
+    };
+    memcpy(payload.channel_data, ev->channel_data,
+           ev->channel_data_size * sizeof(struct zmk_sensor_channel_data));
+    return zmk_split_wired_send(ZMK_SPLIT_WIRED_MSG_SENSOR_EVENT, &payload, sizeof(payload));
+}
+#endif /* ZMK_KEYMAP_HAS_SENSORS */
+
+#if IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+static int split_wired_send_battery_level(uint8_t level) {
+    return zmk_split_wired_send(ZMK_SPLIT_WIRED_MSG_BATTERY_LEVEL, &level, sizeof(level));
+}
+#endif // IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+
+// A UART has no link state, so the central is always considered connected.
+static bool split_wired_is_connected(void) { return true; }
+
+static const struct zmk_split_transport_peripheral_api split_wired_peripheral_api = {
+    .send_position_state = split_wired_send_position_state,
+#if ZMK_KEYMAP_HAS_SENSORS
+    .send_sensor_event = split_wired_send_sensor_event,
+#endif /* ZMK_KEYMAP_HAS_SENSORS */
+#if IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+    .send_battery_level = split_wired_send_battery_level,
+#endif // IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+    .is_connected = split_wired_is_connected,
+};
+
+ZMK_SPLIT_TRANSPORT_PERIPHERAL_DEFINE(&split_wired_peripheral_api);
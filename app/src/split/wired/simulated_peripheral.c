@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/kscan.h>
+#include <zephyr/drivers/serial/uart_emul.h>
+#include <zephyr/sys/crc.h>
+
+#include <string.h>
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/matrix_transform.h>
+#include <zmk/split/transport/types.h>
+#include <zmk/split/wired/wired.h>
+
+#if !DT_HAS_CHOSEN(zmk_split_wired_simulated_kscan)
+#error "The simulated wired peripheral requires a zmk,split-wired-simulated-kscan chosen node"
+#endif
+
+BUILD_ASSERT(DT_NODE_HAS_COMPAT(DT_CHOSEN(zmk_split_uart), zephyr_uart_emul),
+             "The simulated wired peripheral requires a zephyr,uart-emul zmk,split-uart");
+
+// Frames are encoded and decoded here separately from wired.c, so each end checks the other.
+#define FRAME_HEADER_LEN 3
+#define FRAME_CRC_LEN 2
+#define FRAME_MAX_LEN (FRAME_HEADER_LEN + ZMK_SPLIT_WIRED_MAX_PAYLOAD_LEN + FRAME_CRC_LEN)
+
+static const struct device *uart = DEVICE_DT_GET(DT_CHOSEN(zmk_split_uart));
+static const struct device *kscan = DEVICE_DT_GET(DT_CHOSEN(zmk_split_wired_simulated_kscan));
+
+static uint8_t position_state[ZMK_SPLIT_POSITION_STATE_LEN];
+
+// Sent ahead of each frame: stray bytes, then a start of frame with an invalid length. The central
+// has to skip all of it and still receive the frame that follows.
+static uint8_t line_noise[] = {0x00, 0xFF, ZMK_SPLIT_WIRED_FRAME_SOF,
+                               ZMK_SPLIT_WIRED_MSG_POSITION_STATE,
+                               ZMK_SPLIT_WIRED_MAX_PAYLOAD_LEN + 1};
+
+static uint16_t frame_crc(const uint8_t *buf) { return crc16_ccitt(0xFFFF, &buf[1], 2 + buf[2]); }
+
+static void send_frame(uint8_t type, const uint8_t *payload, uint8_t len) {
+    uint8_t buf[FRAME_MAX_LEN] = {ZMK_SPLIT_WIRED_FRAME_SOF, type, len};
+    memcpy(&buf[FRAME_HEADER_LEN], payload, len);
+
+    uint16_t crc = frame_crc(buf);
+
+#if CONFIG_ZMK_SPLIT_WIRED_SIMULATED_PERIPHERAL_CORRUPT_INTERVAL > 0
+    static uint32_t frame_count;
+    if (++frame_count % CONFIG_ZMK_SPLIT_WIRED_SIMULATED_PERIPHERAL_CORRUPT_INTERVAL == 0) {
+        LOG_DBG("Corrupting the CRC of frame %d", frame_count);
+        crc ^= BIT(0);
+    }
+#endif
+
+    buf[FRAME_HEADER_LEN + len] = crc & 0xFF;
+    buf[FRAME_HEADER_LEN + len + 1] = crc >> 8;
+
+    uart_emul_put_rx_data(uart, line_noise, sizeof(line_noise));
+    uart_emul_put_rx_data(uart, buf, FRAME_HEADER_LEN + len + FRAME_CRC_LEN);
+}
+
+static void simulated_peripheral_kscan_callback(const struct device *dev, uint32_t row,
+                                                uint32_t column, bool pressed) {
+    int32_t position = zmk_matrix_transform_row_column_to_position(row, column);
+    if (position < 0 || position >= ZMK_SPLIT_POSITION_STATE_LEN * 8) {
+        LOG_WRN("Not found in transform: row: %d, col: %d", row, column);
+        return;
+    }
+
+    WRITE_BIT(position_state[position / 8], position % 8, pressed);
+    send_frame(ZMK_SPLIT_WIRED_MSG_POSITION_STATE, position_state, sizeof(position_state));
+}
+
+// The simulated peripheral only records the frames it receives.
+static void simulated_peripheral_handle_frame(const uint8_t *buf) {
+    const uint8_t type = buf[1];
+    const uint8_t len = buf[2];
+
+    if (type != ZMK_SPLIT_WIRED_MSG_RUN_BEHAVIOR) {
+        LOG_DBG("frame of type %d", type);
+        return;
+    }
+
+    struct zmk_split_wired_run_behavior_payload payload = {0};
+    memcpy(&payload, &buf[FRAME_HEADER_LEN], MIN(len, sizeof(payload) - 1));
+    LOG_DBG("%s with params %d %d: pressed? %d", payload.behavior_dev, payload.param1,
+            payload.param2, payload.state);
+}
+
+static struct {
+    uint8_t buf[FRAME_MAX_LEN];
+    uint8_t len;
+} rx;
+
+static void simulated_peripheral_rx_byte(uint8_t byte) {
+    if ((rx.len == 0 && byte != ZMK_SPLIT_WIRED_FRAME_SOF) ||
+        (rx.len == 2 && byte > ZMK_SPLIT_WIRED_MAX_PAYLOAD_LEN)) {
+        rx.len = 0;
+        return;
+    }
+
+    rx.buf[rx.len++] = byte;
+    if (rx.len < FRAME_HEADER_LEN || rx.len < FRAME_HEADER_LEN + rx.buf[2] + FRAME_CRC_LEN) {
+        return;
+    }
+
+    uint16_t crc = rx.buf[rx.len - 2] | (rx.buf[rx.len - 1] << 8);
+    if (crc == frame_crc(rx.buf)) {
+        simulated_peripheral_handle_frame(rx.buf);
+    } else {
+        LOG_WRN("Simulated peripheral dropping frame of type %d with bad CRC", rx.buf[1]);
+    }
+
+    rx.len = 0;
+}
+
+static void simulated_peripheral_rx_poll(struct k_work *work) {
+    uint8_t byte;
+
+    while (uart_emul_get_tx_data(uart, &byte, 1) == 1) {
+        simulated_peripheral_rx_byte(byte);
+    }
+
+    k_work_schedule(k_work_delayable_from_work(work),
+                    K_USEC(CONFIG_ZMK_SPLIT_WIRED_POLL_INTERVAL_US));
+}
+
+static K_WORK_DELAYABLE_DEFINE(simulated_peripheral_rx_work, simulated_peripheral_rx_poll);
+
+static int simulated_peripheral_init(void) {
+    if (!device_is_ready(kscan)) {
+        LOG_ERR("Simulated peripheral KSCAN device %s is not ready", kscan->name);
+        return -ENODEV;
+    }
+
+    k_work_schedule(&simulated_peripheral_rx_work, K_NO_WAIT);
+
+    kscan_config(kscan, simulated_peripheral_kscan_callback);
+    kscan_enable_callback(kscan);
+
+    return 0;
+}
+
+SYS_INIT(simulated_peripheral_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -0,0 +1,338 @@
+/*
+ * Copyright (c) 2024 The ZMK Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/uart.h>
+#include <zephyr/sys/crc.h>
+
+#include <string.h>
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+#include <zmk/split/wired/wired.h>
+#include <zmk/workqueue.h>
+
+#if !DT_HAS_CHOSEN(zmk_split_uart)
+#error "The wired split transport requires a zmk,split-uart chosen node"
+#endif
+
+#define FRAME_CRC_LEN 2
+#define FRAME_MAX_LEN (3 + ZMK_SPLIT_WIRED_MAX_PAYLOAD_LEN + FRAME_CRC_LEN)
+
+static const struct device *uart = DEVICE_DT_GET(DT_CHOSEN(zmk_split_uart));
+
+static uint16_t frame_crc(const struct zmk_split_wired_frame *frame) {
+    // The type and length fields are directly followed by the payload.
+    return crc16_ccitt(0xFFFF, (const uint8_t *)frame, 2 + frame->len);
+}
+
+K_MSGQ_DEFINE(split_wired_rx_msgq, sizeof(struct zmk_split_wired_frame),
+              CONFIG_ZMK_SPLIT_WIRED_RX_QUEUE_SIZE, 4);
+
+static void split_wired_rx_work_callback(struct k_work *work) {
+    struct zmk_split_wired_frame frame;
+    while (k_msgq_get(&split_wired_rx_msgq, &frame, K_NO_WAIT) == 0) {
+        zmk_split_wired_handle_frame(&frame);
+    }
+}
+
+K_WORK_DEFINE(split_wired_rx_work, split_wired_rx_work_callback);
+
+enum rx_state {
+    RX_STATE_SOF,
+    RX_STATE_TYPE,
+    RX_STATE_LEN,
+    RX_STATE_PAYLOAD,
+    RX_STATE_CRC_LOW,
+    RX_STATE_CRC_HIGH,
+};
+
+static struct {
+    enum rx_state state;
+    struct zmk_split_wired_frame frame;
+    uint8_t pos;
+    uint16_t crc;
+} rx;
+
+// Called with each received byte, from the UART callback or the polling thread.
+static void rx_byte(uint8_t byte) {
+    switch (rx.state) {
+    case RX_STATE_SOF:
+        if (byte == ZMK_SPLIT_WIRED_FRAME_SOF) {
+            rx.state = RX_STATE_TYPE;
+        }
+        break;
+
+    case RX_STATE_TYPE:
+        rx.frame.type = byte;
+        rx.state = RX_STATE_LEN;
+        break;
+
+    case RX_STATE_LEN:
+        if (byte > ZMK_SPLIT_WIRED_MAX_PAYLOAD_LEN) {
+            rx.state = RX_STATE_SOF;
+            break;
+        }
+        rx.frame.len = byte;
+        rx.pos = 0;
+        rx.state = byte > 0 ? RX_STATE_PAYLOAD : RX_STATE_CRC_LOW;
+        break;
+
+    case RX_STATE_PAYLOAD:
+        rx.frame.payload[rx.pos++] = byte;
+        if (rx.pos == rx.frame.len) {
+            rx.state = RX_STATE_CRC_LOW;
+        }
+        break;
+
+    case RX_STATE_CRC_LOW:
+        rx.crc = byte;
+        rx.state = RX_STATE_CRC_HIGH;
+        break;
+
+    case RX_STATE_CRC_HIGH:
+        rx.crc |= byte << 8;
+        rx.state = RX_STATE_SOF;
+
+        if (rx.crc != frame_crc(&rx.frame)) {
+            LOG_WRN("Dropping split frame of type %d with bad CRC", rx.frame.type);
+            break;
+        }
+
+        if (k_msgq_put(&split_wired_rx_msgq, &rx.frame, K_NO_WAIT) < 0) {
+            LOG_WRN("Split RX queue full, dropping frame of type %d", rx.frame.type);
+            break;
+        }
+
+        k_work_submit_to_queue(zmk_workqueue_input_work_q(), &split_wired_rx_work);
+        break;
+    }
+}
+
+K_THREAD_STACK_DEFINE(split_wired_q_stack, CONFIG_ZMK_SPLIT_WIRED_THREAD_STACK_SIZE);
+
+static struct k_work_q split_wired_work_q;
+
+K_MSGQ_DEFINE(split_wired_tx_msgq, sizeof(struct zmk_split_wired_frame),
+              CONFIG_ZMK_SPLIT_WIRED_TX_QUEUE_SIZE, 4);
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_UART_MODE_ASYNC)
+
+static K_SEM_DEFINE(tx_done_sem, 0, 1);
+
+static uint8_t rx_bufs[2][CONFIG_ZMK_SPLIT_WIRED_RX_BUF_SIZE];
+static uint8_t rx_buf_next;
+
+static void uart_callback(const struct device *dev, struct uart_event *evt, void *user_data) {
+    switch (evt->type) {
+    case UART_TX_DONE:
+    case UART_TX_ABORTED:
+        k_sem_give(&tx_done_sem);
+        break;
+
+    case UART_RX_RDY:
+        for (size_t i = 0; i < evt->data.rx.len; i++) {
+            rx_byte(evt->data.rx.buf[evt->data.rx.offset + i]);
+        }
+        break;
+
+    case UART_RX_BUF_REQUEST:
+        uart_rx_buf_rsp(dev, rx_bufs[rx_buf_next], sizeof(rx_bufs[0]));
+        rx_buf_next = !rx_buf_next;
+        break;
+
+    case UART_RX_DISABLED:
+        uart_rx_enable(dev, rx_bufs[rx_buf_next], sizeof(rx_bufs[0]),
+                       CONFIG_ZMK_SPLIT_WIRED_RX_TIMEOUT_US);
+        rx_buf_next = !rx_buf_next;
+        break;
+
+    default:
+        break;
+    }
+}
+
+static int uart_write(const uint8_t *buf, size_t len) {
+    k_sem_reset(&tx_done_sem);
+
+    int err = uart_tx(uart, buf, len, SYS_FOREVER_US);
+    if (err) {
+        return err;
+    }
+
+    // The buffer must stay untouched until the transfer completes.
+    err = k_sem_take(&tx_done_sem, K_MSEC(100));
+    if (err) {
+        // The buffer is reused for the next frame, so a stalled transfer has to be stopped first.
+        LOG_WRN("Split UART transfer timed out, aborting it");
+        uart_tx_abort(uart);
+        if (k_sem_take(&tx_done_sem, K_MSEC(100))) {
+            LOG_ERR("Split UART transfer did not abort");
+        }
+    }
+
+    return err;
+}
+
+static int uart_start(void) {
+    int err = uart_callback_set(uart, uart_callback, NULL);
+    if (err) {
+        return err;
+    }
+
+    rx_buf_next = 1;
+    return uart_rx_enable(uart, rx_bufs[0], sizeof(rx_bufs[0]),
+                          CONFIG_ZMK_SPLIT_WIRED_RX_TIMEOUT_US);
+}
+
+#else
+
+K_THREAD_STACK_DEFINE(split_wired_rx_stack, CONFIG_ZMK_SPLIT_WIRED_THREAD_STACK_SIZE);
+
+static struct k_thread split_wired_rx_thread;
+
+static void split_wired_rx_poll(void *p1, void *p2, void *p3) {
+    uint8_t byte;
+
+    while (true) {
+        while (uart_poll_in(uart, &byte) == 0) {
+            rx_byte(byte);
+        }
+        k_sleep(K_USEC(CONFIG_ZMK_SPLIT_WIRED_POLL_INTERVAL_US));
+    }
+}
+
+static int uart_write(const uint8_t *buf, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        uart_poll_out(uart, buf[i]);
+    }
+
+    return 0;
+}
+
+static int uart_start(void) {
+    k_thread_create(&split_wired_rx_thread, split_wired_rx_stack,
+                    K_THREAD_STACK_SIZEOF(split_wired_rx_stack), split_wired_rx_poll, NULL, NULL,
+                    NULL, CONFIG_ZMK_SPLIT_WIRED_THREAD_PRIORITY, 0, K_NO_WAIT);
+    k_thread_name_set(&split_wired_rx_thread, "Split Wired RX");
+
+    return 0;
+}
+
+#endif // IS_ENABLED(CONFIG_ZMK_SPLIT_WIRED_UART_MODE_ASYNC)
+
+static void split_wired_tx_work_callback(struct k_work *work) {
+    struct zmk_split_wired_frame frame;
+    static uint8_t buf[FRAME_MAX_LEN];
+
+    while (k_msgq_get(&split_wired_tx_msgq, &frame, K_NO_WAIT) == 0) {
+        uint16_t crc = frame_crc(&frame);
+
+        buf[0] = ZMK_SPLIT_WIRED_FRAME_SOF;
+        buf[1] = frame.type;
+        buf[2] = frame.len;
+        memcpy(&buf[3], frame.payload, frame.len);
+        buf[3 + frame.len] = crc & 0xFF;
+        buf[4 + frame.len] = crc >> 8;
+
+        int err = uart_write(buf, 3 + frame.len + FRAME_CRC_LEN);
+        if (err) {
+            LOG_ERR("Failed to write split frame of type %d (err %d)", frame.type, err);
+        }
+    }
+}
+
+K_WORK_DEFINE(split_wired_tx_work, split_wired_tx_work_callback);
+
+// Only a position state frame can be dropped, and only if a later one in the queue, or the new
+// frame, supersedes it, since each carries the whole position bitmap. Frames such as behavior
+// releases or HID indicators are never dropped.
+static int split_wired_tx_queue_replace(const struct zmk_split_wired_frame *new_frame) {
+    static struct zmk_split_wired_frame frames[CONFIG_ZMK_SPLIT_WIRED_TX_QUEUE_SIZE + 1];
+    int len = 0;
+    int drop = -1;
+
+    while (len < CONFIG_ZMK_SPLIT_WIRED_TX_QUEUE_SIZE &&
+           k_msgq_get(&split_wired_tx_msgq, &frames[len], K_NO_WAIT) == 0) {
+        len++;
+    }
+    frames[len++] = *new_frame;
+
+    bool superseded = false;
+    for (int i = len - 1; i >= 0; i--) {
+        if (frames[i].type == ZMK_SPLIT_WIRED_MSG_POSITION_STATE) {
+            if (superseded) {
+                drop = i;
+            }
+            superseded = true;
+        }
+    }
+
+    for (int i = 0; i < len; i++) {
+        if (i != drop && (drop >= 0 || i < len - 1)) {
+            k_msgq_put(&split_wired_tx_msgq, &frames[i], K_NO_WAIT);
+        }
+    }
+
+    if (drop < 0) {
+        return -ENOMEM;
+    }
+
+    LOG_DBG("Split TX queue full, dropping superseded position state frame");
+    return 0;
+}
+
+int zmk_split_wired_send(enum zmk_split_wired_msg_type type, const void *payload, uint8_t len) {
+    if (len > ZMK_SPLIT_WIRED_MAX_PAYLOAD_LEN) {
+        return -EINVAL;
+    }
+
+    struct zmk_split_wired_frame frame = {.type = type, .len = len};
+    memcpy(frame.payload, payload, len);
+
+    // Keep the TX work from taking frames while the queue is rebuilt.
+    k_sched_lock();
+    int err = k_msgq_put(&split_wired_tx_msgq, &frame, K_NO_WAIT);
+    if (err) {
+        err = split_wired_tx_queue_replace(&frame);
+    }
+    k_sched_unlock();
+
+    if (err) {
+        LOG_WRN("Split TX queue full, dropping frame of type %d", type);
+        return err;
+    }
+
+    k_work_submit_to_queue(&split_wired_work_q, &split_wired_tx_work);
+
+    return 0;
+}
+
+static int zmk_split_wired_init(void) {
+    if (!device_is_ready(uart)) {
+        LOG_ERR("Split UART device %s is not ready", uart->name);
+        return -ENODEV;
+    }
+
+    static const struct k_work_queue_config queue_config = {.name = "Split Wired TX"};
+    k_work_queue_start(&split_wired_work_q, split_wired_q_stack,
+                       K_THREAD_STACK_SIZEOF(split_wired_q_stack),
+                       CONFIG_ZMK_SPLIT_WIRED_THREAD_PRIORITY, &queue_config);
+
+    int err = uart_start();
+    if (err) {
+        LOG_ERR("Failed to start the split UART (err %d)", err);
+    }
+
+    return err;
+}
+
+SYS_INIT(zmk_split_wired_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -17,6 +17,7 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 #include <zmk/events/keycode_state_changed.h>
 
 #include <zmk/wpm.h>
+#include <zmk/workqueue.h>
 
 #define WPM_UPDATE_INTERVAL_SECONDS 1
 #define WPM_RESET_INTERVAL_SECONDS 5
@@ -67,7 +68,9 @@ void wpm_work_handler(struct k_work *work) {
 
 K_WORK_DEFINE(wpm_work, wpm_work_handler);
 
-void wpm_expiry_function(struct k_timer *_timer) { k_work_submit(&wpm_work); }
+void wpm_expiry_function(struct k_timer *_timer) {
+    k_work_submit_to_queue(zmk_workqueue_input_work_q(), &wpm_work);
+}
 
 K_TIMER_DEFINE(wpm_timer, wpm_expiry_function, NULL);
 
@@ -79,7 +82,7 @@ static int wpm_init(void) {
     return 0;
 }
 
-ZMK_LISTENER(wpm, wpm_event_listener);
+ZMK_ASYNC_LISTENER(wpm, wpm_event_listener, CONFIG_ZMK_EVENT_MANAGER_ASYNC_QUEUE_SIZE);
 ZMK_SUBSCRIPTION(wpm, zmk_keycode_state_changed);
 
 SYS_INIT(wpm_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);